@@ -0,0 +1,276 @@
+/**
+ * @file BatchSolver.cpp
+ * @brief Implementation of the BatchSolver class
+ */
+
+#include "BatchSolver.h"
+#include "Solver.h"
+#include "SudokuGrader.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+using Grader = SudokuGrader<3>;
+static_assert(Grader::TECHNIQUE_COUNT == BatchSolver::TECHNIQUE_COUNT, "Summary::hardest size");
+
+// Parses an 81-cell line; false if it is short or has a bad character
+bool parseCells(const std::string &line, Solver::Cells &cells)
+{
+    if (line.size() < 81) {
+        return false;
+    }
+    cells = Solver::Cells{};
+    for (int i = 0; i < 81; ++i) {
+        const char ch = line[i];
+        if (ch >= '1' && ch <= '9') {
+            cells[i] = static_cast<std::uint8_t>(ch - '0');
+        } else if (ch != '0' && ch != '.') {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Percentile of a sorted latency sample, in microseconds
+double percentile(const std::vector<std::uint32_t> &sorted, double fraction)
+{
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    const std::size_t index = static_cast<std::size_t>(fraction * (sorted.size() - 1));
+    return sorted[index] / 1000.0;
+}
+
+void printUsage()
+{
+    std::fprintf(stderr, "Usage: Sudoku --solve-batch <input.txt> [--threads N] [--output <file>]"
+                         " [--diagonal] [--max-iterations N]\n"
+                         "       Sudoku --grade-batch <input.txt> [--threads N] [--output <file>]"
+                         " [--diagonal]\n");
+}
+
+} // namespace
+
+/**
+ * Checks for the batch flag without touching anything else
+ */
+bool BatchSolver::requested(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--solve-batch") == 0 || std::strcmp(argv[i], "--grade-batch") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Parses the batch options, opens the files and prints the summary
+ */
+int BatchSolver::runFromCommandLine(int argc, char *argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--solve-batch" && hasValue) {
+            options.inputPath = argv[++i];
+        } else if (arg == "--grade-batch" && hasValue) {
+            options.mode = Mode::Grade;
+            options.inputPath = argv[++i];
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (arg == "--output" && hasValue) {
+            options.outputPath = argv[++i];
+        } else if (arg == "--max-iterations" && hasValue) {
+            options.maxIterations = std::max<std::int64_t>(1, std::atoll(argv[++i]));
+        } else if (arg == "--diagonal") {
+            options.checkDiagonal = true;
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+    if (options.inputPath.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    std::ifstream in(options.inputPath, std::ios::binary);
+    if (!in) {
+        std::fprintf(stderr, "Could not open input file: %s\n", options.inputPath.c_str());
+        return 1;
+    }
+
+    std::ofstream file;
+    if (!options.outputPath.empty()) {
+        file.open(options.outputPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::fprintf(stderr, "Could not open output file: %s\n", options.outputPath.c_str());
+            return 1;
+        }
+    }
+    std::ostream &out = options.outputPath.empty() ? std::cout : file;
+
+    const Summary summary = run(options, in, out);
+    out.flush();
+
+    const double rate = summary.seconds > 0.0 ? summary.puzzles / summary.seconds : 0.0;
+    const bool grading = options.mode == Mode::Grade;
+    std::fprintf(stderr, "Puzzles:     %lld\n", static_cast<long long>(summary.puzzles));
+    std::fprintf(stderr, "%s%lld\n", grading ? "Invalid:     " : "Unsolvable:  ",
+                 static_cast<long long>(summary.unsolvable));
+    std::fprintf(stderr, "Elapsed:     %g s\n", summary.seconds);
+    std::fprintf(stderr, "Throughput:  %g puzzles/s\n", rate);
+    std::fprintf(stderr, "Latency p50: %g us\n", summary.p50Micros);
+    std::fprintf(stderr, "Latency p99: %g us\n", summary.p99Micros);
+    if (grading) {
+        std::fprintf(stderr, "Hardest technique needed:\n");
+        for (int t = 0; t < TECHNIQUE_COUNT; ++t) {
+            if (summary.hardest[t] > 0) {
+                std::fprintf(stderr, "  %s: %lld\n", Grader::techniqueName(static_cast<Grader::Technique>(t)),
+                             static_cast<long long>(summary.hardest[t]));
+            }
+        }
+    }
+    return out ? 0 : 1;
+}
+
+/**
+ * Reads a chunk, solves or grades it on the pool in TASK_SIZE slices,
+ * writes it in order, and repeats; per-puzzle latencies are kept for the
+ * percentiles
+ */
+BatchSolver::Summary BatchSolver::run(const Options &options, std::istream &in, std::ostream &out)
+{
+    Summary summary;
+    WorkStealingPool pool(options.threads);
+    std::atomic<std::int64_t> unsolvable(0);
+    std::array<std::atomic<std::int64_t>, TECHNIQUE_COUNT> hardest{};
+    std::vector<std::uint32_t> latencies;
+
+    std::vector<std::string> chunk;
+    std::vector<std::uint32_t> chunkLatencies;
+    chunk.reserve(CHUNK_SIZE);
+    std::string line;
+
+    const auto start = std::chrono::steady_clock::now();
+    bool more = true;
+    while (more) {
+        chunk.clear();
+        while (static_cast<int>(chunk.size()) < CHUNK_SIZE && (more = static_cast<bool>(std::getline(in, line)))) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            chunk.push_back(line);
+        }
+        if (chunk.empty()) {
+            break;
+        }
+
+        const int count = static_cast<int>(chunk.size());
+        chunkLatencies.assign(count, 0);
+        for (int first = 0; first < count; first += TASK_SIZE) {
+            const int last = std::min(count, first + TASK_SIZE);
+            pool.submit([&, first, last]() {
+                for (int i = first; i < last; ++i) {
+                    const auto begin = std::chrono::steady_clock::now();
+                    if (options.mode == Mode::Grade) {
+                        const int technique = gradeLine(chunk[i], options);
+                        if (technique < 0) {
+                            unsolvable.fetch_add(1, std::memory_order_relaxed);
+                        } else {
+                            hardest[technique].fetch_add(1, std::memory_order_relaxed);
+                        }
+                    } else if (!solveLine(chunk[i], options)) {
+                        unsolvable.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - begin).count();
+                    chunkLatencies[i] = static_cast<std::uint32_t>(
+                        std::min<long long>(nanos, UINT32_MAX));
+                }
+            });
+        }
+        pool.wait();
+
+        for (const std::string &result : chunk) {
+            out << result << '\n';
+        }
+        latencies.insert(latencies.end(), chunkLatencies.begin(), chunkLatencies.end());
+        summary.puzzles += count;
+    }
+
+    summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    summary.unsolvable = unsolvable.load();
+    for (int t = 0; t < TECHNIQUE_COUNT; ++t) {
+        summary.hardest[t] = hardest[t].load();
+    }
+    std::sort(latencies.begin(), latencies.end());
+    summary.p50Micros = percentile(latencies, 0.50);
+    summary.p99Micros = percentile(latencies, 0.99);
+    return summary;
+}
+
+/**
+ * Parses one line into cells, solves it and replaces it by the result
+ */
+bool BatchSolver::solveLine(std::string &line, const Options &options)
+{
+    static const std::string kUnsolvable = "unsolvable";
+
+    Solver::Cells cells;
+    if (!parseCells(line, cells)) {
+        line = kUnsolvable;
+        return false;
+    }
+
+    if (!Solver::solveCells(cells, options.checkDiagonal, options.maxIterations)) {
+        line = kUnsolvable;
+        return false;
+    }
+
+    line.resize(81);
+    for (int i = 0; i < 81; ++i) {
+        line[i] = static_cast<char>('0' + cells[i]);
+    }
+    return true;
+}
+
+/**
+ * Parses one line, grades it and replaces it by "<puzzle> <rating> <technique>"
+ */
+int BatchSolver::gradeLine(std::string &line, const Options &options)
+{
+    static const std::string kInvalid = "invalid";
+
+    Solver::Cells cells;
+    if (!parseCells(line, cells)) {
+        line = kInvalid;
+        return -1;
+    }
+
+    const Grader::Grade grade = Grader::grade(cells, options.checkDiagonal);
+    if (!grade.valid) {
+        line = kInvalid;
+        return -1;
+    }
+
+    char rating[16];
+    std::snprintf(rating, sizeof(rating), " %.2f ", grade.rating());
+    line.resize(81);
+    line += rating;
+    line += Grader::techniqueName(grade.hardest);
+    return static_cast<int>(grade.hardest);
+}
@@ -0,0 +1,117 @@
+/**
+ * @file BatchSolver.h
+ * @brief Header file for the BatchSolver class, the headless bulk-solve and
+ * bulk-grade modes
+ *
+ * This class is responsible for:
+ * - Streaming puzzles in the standard 81-character line format
+ * - Solving or grading them in parallel on a work-stealing pool
+ * - Writing results in input order and reporting throughput statistics
+ */
+
+#ifndef BATCHSOLVER_H
+#define BATCHSOLVER_H
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/**
+ * @class BatchSolver
+ * @brief Solves large puzzle files without any GUI objects
+ *
+ * Input lines hold 81 cells, digits 1-9 for givens and '0' or '.' for blanks;
+ * blank lines and lines starting with '#' are skipped. Each puzzle produces
+ * one output line: the 81-digit solution, or "unsolvable" (which also covers
+ * malformed lines). Input is processed in fixed-size chunks so memory stays
+ * bounded regardless of file size.
+ *
+ * In grade mode ("--grade-batch") each output line is the puzzle, its
+ * SudokuGrader rating and the hardest technique it needs, e.g.
+ * "<81 cells> 8.03 X-Wing", or "invalid". Sorting the output on the second
+ * field orders a library by difficulty.
+ */
+class BatchSolver
+{
+public:
+    /** @brief What to do with each puzzle */
+    enum class Mode {
+        Solve,
+        Grade
+    };
+
+    /** @brief Techniques counted in Summary::hardest (SudokuGrader::TECHNIQUE_COUNT) */
+    static constexpr int TECHNIQUE_COUNT = 14;
+
+    /** @brief Options for one batch run */
+    struct Options {
+        Mode mode = Mode::Solve;
+        std::string inputPath;
+        std::string outputPath;        ///< Empty: write solutions to stdout
+        int threads = 0;               ///< 0: hardware concurrency
+        bool checkDiagonal = false;
+        std::int64_t maxIterations = 1000000;
+    };
+
+    /** @brief Totals of one batch run */
+    struct Summary {
+        std::int64_t puzzles = 0;
+        std::int64_t unsolvable = 0;
+        double seconds = 0.0;
+        double p50Micros = 0.0;        ///< Median per-puzzle latency
+        double p99Micros = 0.0;        ///< 99th percentile per-puzzle latency
+        std::array<std::int64_t, TECHNIQUE_COUNT> hardest{}; ///< Grade mode: puzzles per hardest technique
+    };
+
+    /**
+     * @brief Entry point for "--solve-batch" and "--grade-batch" from main()
+     * @param argc Argument count as passed to main
+     * @param argv Argument vector as passed to main
+     * @return Process exit code
+     */
+    static int runFromCommandLine(int argc, char *argv[]);
+
+    /**
+     * @brief Whether the command line asks for the headless batch mode
+     * @param argc Argument count as passed to main
+     * @param argv Argument vector as passed to main
+     * @return True if "--solve-batch" or "--grade-batch" is present
+     */
+    static bool requested(int argc, char *argv[]);
+
+    /**
+     * @brief Solves or grades every puzzle of a stream
+     * @param options Run configuration (inputPath/outputPath are not used)
+     * @param in Puzzle lines
+     * @param out Receives one result line per puzzle, in input order
+     * @return Run totals
+     */
+    static Summary run(const Options &options, std::istream &in, std::ostream &out);
+
+private:
+    /** @brief Puzzles read and solved per chunk */
+    static constexpr int CHUNK_SIZE = 16384;
+    /** @brief Puzzles per pool task */
+    static constexpr int TASK_SIZE = 64;
+
+    /**
+     * @brief Solves one line in place
+     * @param line Puzzle line; replaced by the result line
+     * @param options Run configuration
+     * @return True if the puzzle was solved
+     */
+    static bool solveLine(std::string &line, const Options &options);
+
+    /**
+     * @brief Grades one line in place
+     * @param line Puzzle line; replaced by the result line
+     * @param options Run configuration
+     * @return Hardest technique (SudokuGrader::Technique as int), or -1 if
+     *         the line is malformed or the puzzle contradicts itself
+     */
+    static int gradeLine(std::string &line, const Options &options);
+};
+
+#endif // BATCHSOLVER_H
@@ -0,0 +1,572 @@
+/**
+ * @file Benchmark.cpp
+ * @brief Implementation of the Benchmark class
+ */
+
+#include "Benchmark.h"
+#include "CanonicalForm.h"
+#include "DlxSolver.h"
+#include "GridFactory.h"
+#include "HistoryRead.h"
+#include "HistoryStore.h"
+#include "LegacyHistoryParser.h"
+#include "LaneSolver.h"
+#include "Solver.h"
+#include "SudokuGenerator.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonValue>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+/** @brief A named, fixed list of 9x9 puzzles in 81-character form */
+struct Corpus {
+    const char *name;
+    std::vector<const char *> puzzles;
+};
+
+// Fixed corpora. Never edit these in place: reports are only comparable
+// when they measured the same puzzles; add a new corpus instead.
+const std::vector<Corpus> &corpora()
+{
+    static const std::vector<Corpus> kCorpora = {
+        {"easy", {
+            "530070000600195000098000060800060003400803001700020006060000280000419005000080079",
+            "003020600900305001001806400008102900700000008006708200002609500800203009005010300",
+            "200080300060070084030500209000105408000000000402706000301007040720040060004010003",
+            "000000907000420180000705026100904000050000040000507009920108000034059000507000000",
+            "030050040008010500460000012070502080000603000040109030250000098001020600080060020",
+        }},
+        {"hard", {
+            "100007090030020008009600500005300900010080002600004000300000010040000007007000300",
+            "100000002090400050006000700050903000000070000000850040700000600030009080002000001",
+            "000000039000001005003050800008090006070002000100400000009080050020000600400700000",
+            "800000000003600000070090200050007000000045700000100030001000068008500010090000400",
+            "000000012000000003002300400001800005060070800000009000008500000900040500470006000",
+        }},
+        {"minimal17", {
+            "000000010400000000020000000000050407008000300001090000300400200050100000000806000",
+            "000000010400000000020000000000050604008000300001090000300400200050100000000807000",
+            "000000012000035000000600070700000300000400800100000000000120000080000040050000600",
+            "000000012003600000000007000410020000000500300700000600280000040000300500000000000",
+            "000000012008030000000000040120500000000004700060000000507000300000620000000100000",
+        }},
+        // Worst cases for naive in-order backtracking: the first row of the
+        // solution is 987654321, and a sparse puzzle with many solutions
+        {"worstcase", {
+            "000000000000003085001020000000507000004000100090000000500000073002010000000040009",
+            "000006000059000008200008000045000000003000000006003054000325006000000000000000000",
+        }},
+    };
+    return kCorpora;
+}
+
+Solver::Cells toCells(const char *puzzle)
+{
+    Solver::Cells cells{};
+    for (int i = 0; i < 81; ++i) {
+        cells[i] = static_cast<std::uint8_t>(puzzle[i] - '0');
+    }
+    return cells;
+}
+
+// Milliseconds at a fraction of a sorted sample
+double percentile(const std::vector<double> &sorted, double fraction)
+{
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    return sorted[static_cast<std::size_t>(fraction * (sorted.size() - 1))];
+}
+
+/**
+ * @brief Repeats passes of a solve function over a corpus until minSeconds
+ * have elapsed and reports the rates
+ * @param solvePass Solves every puzzle once; adds to solved and nodes
+ */
+template <typename Pass>
+QJsonObject timeEngine(double minSeconds, int corpusSize, Pass &&solvePass)
+{
+    qint64 puzzles = 0;
+    qint64 solved = 0;
+    qint64 nodes = 0;
+    QElapsedTimer timer;
+    timer.start();
+    do {
+        solvePass(solved, nodes);
+        puzzles += corpusSize;
+    } while (timer.nsecsElapsed() < static_cast<qint64>(minSeconds * 1e9));
+    const double seconds = timer.nsecsElapsed() / 1e9;
+
+    QJsonObject result;
+    result.insert("puzzles", static_cast<double>(puzzles));
+    result.insert("solved", static_cast<double>(solved));
+    result.insert("seconds", seconds);
+    result.insert("puzzlesPerSec", puzzles / seconds);
+    if (nodes > 0) {
+        result.insert("nodes", static_cast<double>(nodes));
+        result.insert("nodesPerSec", nodes / seconds);
+    }
+    return result;
+}
+
+void printUsage()
+{
+    std::fprintf(stderr, "Usage: Sudoku --benchmark [--output <report.json>]"
+                         " [--baseline <report.json>] [--quick]\n");
+}
+
+} // namespace
+
+/**
+ * Checks for the benchmark flag without touching anything else
+ */
+bool Benchmark::requested(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--benchmark") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Parses the options, runs the suite, writes the report and, when a
+ * baseline is given, prints the differences to stderr
+ */
+int Benchmark::runFromCommandLine(int argc, char *argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const QString arg = QString::fromLocal8Bit(argv[i]);
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--benchmark") {
+            continue;
+        } else if (arg == "--output" && hasValue) {
+            options.outputPath = QString::fromLocal8Bit(argv[++i]);
+        } else if (arg == "--baseline" && hasValue) {
+            options.baselinePath = QString::fromLocal8Bit(argv[++i]);
+        } else if (arg == "--quick") {
+            // Smoke-test sizes: enough to catch a gross regression quickly
+            options.minSeconds = 0.1;
+            options.generateSamples = 10;
+            options.historySizes = {10000};
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+
+    QJsonObject baseline;
+    if (!options.baselinePath.isEmpty()) {
+        QFile file(options.baselinePath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            std::fprintf(stderr, "Could not open baseline: %s\n", qPrintable(options.baselinePath));
+            return 1;
+        }
+        baseline = QJsonDocument::fromJson(file.readAll()).object();
+    }
+
+    const QJsonObject report = run(options);
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+
+    if (options.outputPath.isEmpty()) {
+        std::fwrite(json.constData(), 1, static_cast<std::size_t>(json.size()), stdout);
+    } else {
+        QFile file(options.outputPath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+            std::fprintf(stderr, "Could not write report: %s\n", qPrintable(options.outputPath));
+            return 1;
+        }
+    }
+
+    if (!baseline.isEmpty()) {
+        compare(baseline, report);
+    }
+    return 0;
+}
+
+/**
+ * Runs the sections in order; each one is independent of the others
+ */
+QJsonObject Benchmark::run(const Options &options)
+{
+    QJsonObject report;
+    report.insert("format", 1);
+    report.insert("qtVersion", QString(qVersion()));
+    report.insert("threads", QThread::idealThreadCount());
+    report.insert("laneInstructionSet", QString(LaneSolver::instructionSet()));
+    report.insert("solver", benchmarkSolver(options));
+    report.insert("grids", benchmarkGrids(options));
+    report.insert("canonical", benchmarkCanonical(options));
+    report.insert("generator", benchmarkGenerator(options));
+    report.insert("history", benchmarkHistory(options));
+    return report;
+}
+
+/**
+ * Every corpus through the backtracking engine, DLX and the lane solver.
+ * The lane solver gets the corpus repeated to fill its lanes and reports no
+ * node counts; the other engines report search nodes per second.
+ */
+QJsonObject Benchmark::benchmarkSolver(const Options &options)
+{
+    QJsonObject section;
+    DlxSolver dlx(false);
+
+    for (const Corpus &corpus : corpora()) {
+        std::vector<Solver::Cells> puzzles;
+        for (const char *puzzle : corpus.puzzles) {
+            puzzles.push_back(toCells(puzzle));
+        }
+        const int size = static_cast<int>(puzzles.size());
+        QJsonObject engines;
+
+        engines.insert("backtrack", timeEngine(options.minSeconds, size, [&](qint64 &solved, qint64 &nodes) {
+            for (const Solver::Cells &puzzle : puzzles) {
+                Solver::Cells cells = puzzle;
+                qint64 visited = 0;
+                solved += Solver::solveCells(cells, false, 100000000, &visited);
+                nodes += visited;
+            }
+        }));
+
+        engines.insert("dlx", timeEngine(options.minSeconds, size, [&](qint64 &solved, qint64 &nodes) {
+            for (const Solver::Cells &puzzle : puzzles) {
+                Solver::Cells solution;
+                std::int64_t visited = 0;
+                solved += dlx.solve(puzzle, solution, 100000000, visited);
+                nodes += visited;
+            }
+        }));
+
+        std::vector<LaneSolver::Board> lanes;
+        while (static_cast<int>(lanes.size()) < LaneSolver::LANES * 4) {
+            lanes.insert(lanes.end(), puzzles.begin(), puzzles.end());
+        }
+        std::vector<LaneSolver::Board> solutions;
+        engines.insert("lanes", timeEngine(options.minSeconds, static_cast<int>(lanes.size()),
+                                           [&](qint64 &solved, qint64 &) {
+            solved += static_cast<qint64>(LaneSolver::solveMany(lanes, solutions));
+        }));
+
+        section.insert(corpus.name, engines);
+    }
+    return section;
+}
+
+/**
+ * Complete-grid production rate per box size: the randomized search fill
+ * that the generator used to run for every puzzle, against the
+ * transformation stream it uses now. Both use a fixed RNG seed. The
+ * factory's one-off seed search is timed separately.
+ */
+QJsonObject Benchmark::benchmarkGrids(const Options &options)
+{
+    constexpr std::int64_t kFillNodeBudget = 100000;
+    constexpr int kSeedGrids = 16;
+    const qint64 minNanos = static_cast<qint64>(options.minSeconds * 1e9);
+
+    QJsonObject section;
+    for (int boxSize = 2; boxSize <= 5; ++boxSize) {
+        dispatchBoxSize(boxSize, [&](auto box) {
+            constexpr int N = decltype(box)::value;
+            using Engine = SudokuEngine<N>;
+            using Factory = GridFactory<N>;
+            std::mt19937 rng(12345);
+            std::uint32_t checksum = 0; // Keeps the grids observable
+
+            qint64 grids = 0;
+            QElapsedTimer timer;
+            timer.start();
+            do {
+                typename Engine::State state;
+                do {
+                    Engine::load(typename Engine::Cells{}, state, false);
+                } while (!Engine::fillRandom(state, rng, false, kFillNodeBudget));
+                checksum += state.cells[0];
+                ++grids;
+            } while (timer.nsecsElapsed() < minNanos);
+            const double searchSeconds = timer.nsecsElapsed() / 1e9;
+
+            timer.start();
+            const Factory factory(rng, kSeedGrids, kFillNodeBudget);
+            const double setupMs = timer.nsecsElapsed() / 1e6;
+
+            qint64 transformed = 0;
+            typename Factory::Cells cells;
+            timer.start();
+            do {
+                for (int i = 0; i < 1000; ++i) {
+                    factory.next(cells, rng);
+                    checksum += cells[i % Factory::CELL_COUNT];
+                }
+                transformed += 1000;
+            } while (timer.nsecsElapsed() < minNanos);
+            const double transformSeconds = timer.nsecsElapsed() / 1e9;
+
+            QJsonObject search;
+            search.insert("grids", static_cast<double>(grids));
+            search.insert("gridsPerSec", grids / searchSeconds);
+
+            QJsonObject transform;
+            transform.insert("grids", static_cast<double>(transformed));
+            transform.insert("gridsPerSec", transformed / transformSeconds);
+            transform.insert("nsPerGrid", transformSeconds * 1e9 / transformed);
+            transform.insert("seedSetupMs", setupMs);
+            transform.insert("checksum", static_cast<double>(checksum));
+
+            QJsonObject result;
+            result.insert("search", search);
+            result.insert("transform", transform);
+            section.insert(QString("%1x%1").arg(Factory::GRID_SIZE), result);
+        });
+    }
+    return section;
+}
+
+/**
+ * Canonicalization rate per box size, on GridFactory grids with a random
+ * half of the cells kept as givens. This is the per-puzzle cost of the
+ * generator's history check and of indexing a history file.
+ */
+QJsonObject Benchmark::benchmarkCanonical(const Options &options)
+{
+    constexpr int kPuzzles = 64;
+    const qint64 minNanos = static_cast<qint64>(options.minSeconds * 1e9);
+
+    QJsonObject section;
+    for (int boxSize = 2; boxSize <= 5; ++boxSize) {
+        dispatchBoxSize(boxSize, [&](auto box) {
+            constexpr int N = decltype(box)::value;
+            using Factory = GridFactory<N>;
+            using Form = CanonicalForm<N>;
+            std::mt19937 rng(12345);
+            const Factory factory(rng, 16, 100000);
+
+            std::vector<std::pair<typename Form::Cells, typename Form::Cells>> puzzles(kPuzzles);
+            for (auto &puzzle : puzzles) {
+                factory.next(puzzle.first, rng);
+                for (int i = 0; i < Form::CELL_COUNT; ++i) {
+                    puzzle.second[i] = (rng() & 1) ? puzzle.first[i] : 0;
+                }
+            }
+
+            std::uint64_t checksum = 0; // Keeps the forms observable
+            qint64 forms = 0;
+            typename Form::Cells form;
+            QElapsedTimer timer;
+            timer.start();
+            do {
+                for (const auto &puzzle : puzzles) {
+                    Form::canonicalize(puzzle.first, puzzle.second, form);
+                    checksum ^= Form::hash(form);
+                }
+                forms += kPuzzles;
+            } while (timer.nsecsElapsed() < minNanos);
+            const double seconds = timer.nsecsElapsed() / 1e9;
+
+            QJsonObject result;
+            result.insert("forms", static_cast<double>(forms));
+            result.insert("formsPerSec", forms / seconds);
+            result.insert("usPerForm", seconds * 1e6 / forms);
+            result.insert("checksum", static_cast<double>(checksum & 0xffffffffu));
+            section.insert(QString("%1x%1").arg(Form::GRID_SIZE), result);
+        });
+    }
+    return section;
+}
+
+/**
+ * Latency of SudokuGenerator::generateSudoku, which includes the full-grid
+ * fill and the uniqueness-checked cell removal. The puzzle pool is turned
+ * off so every sample measures real generation rather than a buffer pop.
+ */
+QJsonObject Benchmark::benchmarkGenerator(const Options &options)
+{
+    static const char *const kDifficulties[] = {"easy", "medium", "hard"};
+
+    QJsonObject section;
+    SudokuGenerator generator;
+    generator.setPoolCapacity(0);
+    for (int difficulty = 1; difficulty <= 3; ++difficulty) {
+        std::vector<double> latencies;
+        latencies.reserve(options.generateSamples);
+        double total = 0.0;
+        for (int i = 0; i < options.generateSamples; ++i) {
+            QElapsedTimer timer;
+            timer.start();
+            generator.generateSudoku(difficulty);
+            const double ms = timer.nsecsElapsed() / 1e6;
+            latencies.push_back(ms);
+            total += ms;
+        }
+        std::sort(latencies.begin(), latencies.end());
+
+        QJsonObject result;
+        result.insert("samples", options.generateSamples);
+        result.insert("meanMs", latencies.empty() ? 0.0 : total / latencies.size());
+        result.insert("p50Ms", percentile(latencies, 0.50));
+        result.insert("p99Ms", percentile(latencies, 0.99));
+        result.insert("maxMs", latencies.empty() ? 0.0 : latencies.back());
+        section.insert(kDifficulties[difficulty - 1], result);
+    }
+    return section;
+}
+
+/**
+ * Writes history files in the legacy text format to a temporary directory
+ * and times HistoryRead and the bare LegacyHistoryParser on them, then
+ * migrates each into a HistoryStore and times opening it cold (index
+ * rebuilt), warm (index loaded) and reading entries at random. The entries
+ * are deterministic, so the files are byte-identical between runs.
+ */
+QJsonObject Benchmark::benchmarkHistory(const Options &options)
+{
+    QJsonObject section;
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        std::fprintf(stderr, "Could not create a temporary directory for history files\n");
+        return section;
+    }
+
+    const Solver::Cells grid = toCells(corpora().front().puzzles.front());
+    for (int entries : options.historySizes) {
+        const QString filePath = dir.filePath(QString("history_%1.txt").arg(entries));
+        {
+            QFile file(filePath);
+            if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+                std::fprintf(stderr, "Could not write %s\n", qPrintable(filePath));
+                continue;
+            }
+            QTextStream out(&file);
+            for (int i = 0; i < entries; ++i) {
+                out << "--- Puzzle Entry ---\n";
+                out << "Date: 2024-01-01 " << QString("%1:%2:%3\n")
+                                                  .arg(i / 3600 % 24, 2, 10, QChar('0'))
+                                                  .arg(i / 60 % 60, 2, 10, QChar('0'))
+                                                  .arg(i % 60, 2, 10, QChar('0'));
+                out << "Completion Time (seconds): " << 60 + i % 900 << "\n";
+                out << "Difficulty: " << 1 + i % 3 << "\n";
+                out << "Puzzle:\n";
+                for (int r = 0; r < 9; ++r) {
+                    for (int c = 0; c < 9; ++c) {
+                        // Vary the digits per entry without breaking the grid's shape
+                        const int cell = grid[r * 9 + c];
+                        out << (cell == 0 ? 0 : (cell + i) % 9 + 1) << " ";
+                    }
+                    out << "\n";
+                }
+            }
+        }
+
+        HistoryRead reader;
+        QElapsedTimer timer;
+        timer.start();
+        const QVariantList history = reader.readHistoryFile(filePath);
+        const double ms = timer.nsecsElapsed() / 1e6;
+
+        QJsonObject result;
+        result.insert("entries", history.size());
+        result.insert("fileBytes", static_cast<double>(QFileInfo(filePath).size()));
+        result.insert("loadMs", ms);
+        result.insert("entriesPerSec", ms > 0.0 ? history.size() / (ms / 1000.0) : 0.0);
+
+        // The streaming parser alone, without building the QVariant maps
+        qint64 parsed = 0;
+        timer.restart();
+        LegacyHistoryParser::parseFile(filePath, [&parsed](const LegacyHistoryParser::Entry &entry) {
+            parsed += entry.time();
+        });
+        const double parseMs = timer.nsecsElapsed() / 1e6;
+        result.insert("parseMs", parseMs);
+        result.insert("parseMBPerSec", parseMs > 0.0 ? QFileInfo(filePath).size() / 1e6 / (parseMs / 1000.0) : 0.0);
+        result.insert("parseChecksum", static_cast<double>(parsed));
+
+        const QString storePath = dir.filePath(QString("history_%1.bin").arg(entries));
+        timer.restart();
+        const int migrated = HistoryStore::migrateLegacy(filePath, storePath);
+        result.insert("migrateMs", timer.nsecsElapsed() / 1e6);
+        result.insert("storeBytes", static_cast<double>(QFileInfo(storePath).size()));
+        QFile::remove(filePath); // The 1M-entry file is large; don't keep it around
+
+        // Warm uses the offset index migration wrote; opening never writes
+        // one, so without it every open is cold
+        const auto timeOpen = [&]() {
+            HistoryStore store(storePath);
+            timer.restart();
+            store.open();
+            return timer.nsecsElapsed() / 1e6;
+        };
+        result.insert("warmOpenMs", timeOpen());
+        QFile::remove(HistoryStore::offsetsPathFor(storePath));
+        result.insert("coldOpenMs", timeOpen());
+
+        HistoryStore store(storePath);
+        store.open();
+        if (migrated > 0 && store.count() == migrated) {
+            std::mt19937 rng(12345);
+            std::uniform_int_distribution<int> pick(0, migrated - 1);
+            constexpr int kReads = 100000;
+            HistoryStore::Entry entry;
+            qint64 checksum = 0; // Keeps the reads observable
+            timer.restart();
+            for (int i = 0; i < kReads; ++i) {
+                if (store.entry(pick(rng), entry)) {
+                    checksum += entry.time + entry.grid.cell(0);
+                }
+            }
+            const double readMs = timer.nsecsElapsed() / 1e6;
+            result.insert("randomReadsPerSec", readMs > 0.0 ? kReads / (readMs / 1000.0) : 0.0);
+            result.insert("readChecksum", static_cast<double>(checksum));
+        } else {
+            std::fprintf(stderr, "Migrated %d of %d history entries\n", migrated, entries);
+        }
+        QFile::remove(storePath);
+        QFile::remove(HistoryStore::offsetsPathFor(storePath));
+
+        section.insert(QString::number(entries), result);
+    }
+    return section;
+}
+
+/**
+ * Walks both reports in parallel. Keys ending in "PerSec" are rates
+ * (higher is better), keys ending in "Ms" are latencies (lower is better);
+ * anything else is context and is not compared.
+ */
+void Benchmark::compare(const QJsonObject &baseline, const QJsonObject &current, const QString &path)
+{
+    for (auto it = current.begin(); it != current.end(); ++it) {
+        const QString key = path.isEmpty() ? it.key() : path + "." + it.key();
+        const QJsonValue before = baseline.value(it.key());
+
+        if (it.value().isObject() && before.isObject()) {
+            compare(before.toObject(), it.value().toObject(), key);
+            continue;
+        }
+
+        const bool rate = it.key().endsWith("PerSec");
+        const bool latency = it.key().endsWith("Ms");
+        if ((!rate && !latency) || !before.isDouble() || !it.value().isDouble() || before.toDouble() == 0.0) {
+            continue;
+        }
+
+        const double change = (it.value().toDouble() - before.toDouble()) / before.toDouble() * 100.0;
+        const bool better = rate ? change > 0.0 : change < 0.0;
+        std::fprintf(stderr, "%-45s %12.3f -> %12.3f  %+7.1f%% %s\n", qPrintable(key),
+                     before.toDouble(), it.value().toDouble(), change,
+                     change == 0.0 ? "" : (better ? "better" : "worse"));
+    }
+}
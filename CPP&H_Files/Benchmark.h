@@ -0,0 +1,107 @@
+/**
+ * @file Benchmark.h
+ * @brief Header file for the Benchmark class, the headless performance suite
+ *
+ * This class is responsible for:
+ * - Timing the solver engines on fixed puzzle corpora
+ * - Comparing search-based and transformation-based full-grid production
+ * - Timing puzzle canonicalization per box size
+ * - Measuring puzzle generation latency per difficulty
+ * - Measuring history load time on synthetic history files, in the legacy
+ *   text format and in the HistoryStore
+ * - Writing the results as JSON and comparing them with a saved baseline
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+/**
+ * @class Benchmark
+ * @brief Runs the "--benchmark" suite without any GUI objects
+ *
+ * Every number comes from corpora compiled into the binary or generated
+ * deterministically at run time, so two runs on the same machine measure
+ * the same work and their JSON reports can be compared key by key.
+ */
+class Benchmark
+{
+public:
+    /** @brief Options for one benchmark run */
+    struct Options {
+        QString outputPath;           ///< Empty: write the JSON report to stdout
+        QString baselinePath;         ///< Earlier report to compare against, optional
+        double minSeconds = 0.5;      ///< Minimum measuring time per solver case
+        int generateSamples = 50;     ///< Puzzles generated per difficulty
+        QVector<int> historySizes{10000, 1000000}; ///< Entries per synthetic history file
+    };
+
+    /**
+     * @brief Whether the command line asks for the benchmark suite
+     * @param argc Argument count as passed to main
+     * @param argv Argument vector as passed to main
+     * @return True if "--benchmark" is present
+     */
+    static bool requested(int argc, char *argv[]);
+
+    /**
+     * @brief Entry point for "--benchmark" from main()
+     * @param argc Argument count as passed to main
+     * @param argv Argument vector as passed to main
+     * @return Process exit code
+     */
+    static int runFromCommandLine(int argc, char *argv[]);
+
+    /**
+     * @brief Runs every section of the suite
+     * @param options Run configuration
+     * @return Report with "solver", "grids", "generator" and "history" sections
+     */
+    static QJsonObject run(const Options &options);
+
+private:
+    /**
+     * @brief Solves each corpus with every engine for at least minSeconds
+     * @return Per corpus and engine: puzzles/s, nodes/s and solved count
+     */
+    static QJsonObject benchmarkSolver(const Options &options);
+
+    /**
+     * @brief Produces complete grids by search and by GridFactory per box size
+     * @return Per size and method: grids/s, plus the factory's seed setup time
+     */
+    static QJsonObject benchmarkGrids(const Options &options);
+
+    /**
+     * @brief Reduces puzzles to their CanonicalForm per box size
+     * @return Per size: forms/s and microseconds per form
+     */
+    static QJsonObject benchmarkCanonical(const Options &options);
+
+    /**
+     * @brief Generates puzzles of each difficulty and records the latency
+     * @return Per difficulty: mean, p50, p99 and max in milliseconds
+     */
+    static QJsonObject benchmarkGenerator(const Options &options);
+
+    /**
+     * @brief Writes synthetic history files and times loading them
+     * @return Per file size: entries, bytes and load time of the text file;
+     *         migration, open and random-read times of the store
+     */
+    static QJsonObject benchmarkHistory(const Options &options);
+
+    /**
+     * @brief Prints every rate and latency that differs from the baseline
+     * @param baseline Earlier report
+     * @param current This run's report
+     * @param path Key path of the objects being compared, for the printout
+     */
+    static void compare(const QJsonObject &baseline, const QJsonObject &current,
+                        const QString &path = QString());
+};
+
+#endif // BENCHMARK_H
@@ -0,0 +1,177 @@
+/**
+ * @file Board.cpp
+ * @brief Implementation of the Board value type
+ */
+
+#include "Board.h"
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief Box side for a grid side length, 0 if it is not a supported square
+ */
+int boxSizeForSide(int side)
+{
+    for (int box = 2; box <= 5; ++box) {
+        if (box * box == side) {
+            return box;
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+Board::Board(int boxSize)
+{
+    if (boxSize >= 2 && boxSize <= 5) {
+        m_boxSize = boxSize;
+        m_cells = QByteArray(boxSize * boxSize * boxSize * boxSize, '\0');
+    }
+}
+
+Board Board::fromGrid(const Grid &grid)
+{
+    const int side = static_cast<int>(grid.size());
+    Board board(boxSizeForSide(side));
+    if (!board.isValid()) {
+        return Board();
+    }
+
+    std::uint8_t *cells = board.cells();
+    for (int r = 0; r < side; ++r) {
+        if (static_cast<int>(grid[r].size()) != side) {
+            return Board();
+        }
+        for (int c = 0; c < side; ++c) {
+            const int value = grid[r][c];
+            if (value < 0 || value > side) {
+                return Board();
+            }
+            cells[r * side + c] = static_cast<std::uint8_t>(value);
+        }
+    }
+    return board;
+}
+
+/**
+ * Reads the rows in place; no intermediate grid is built
+ */
+Board Board::fromVariantList(const QVariantList &rows)
+{
+    const int side = static_cast<int>(rows.size());
+    Board board(boxSizeForSide(side));
+    if (!board.isValid()) {
+        return Board();
+    }
+
+    std::uint8_t *cells = board.cells();
+    for (int r = 0; r < side; ++r) {
+        const QVariantList row = rows[r].toList();
+        if (static_cast<int>(row.size()) != side) {
+            return Board();
+        }
+        for (int c = 0; c < side; ++c) {
+            const int value = row[c].toInt();
+            if (value < 0 || value > side) {
+                return Board();
+            }
+            cells[r * side + c] = static_cast<std::uint8_t>(value);
+        }
+    }
+    return board;
+}
+
+bool Board::isValid() const
+{
+    return m_boxSize != 0;
+}
+
+int Board::boxSize() const
+{
+    return m_boxSize;
+}
+
+int Board::size() const
+{
+    return m_boxSize * m_boxSize;
+}
+
+int Board::cellCount() const
+{
+    return static_cast<int>(m_cells.size());
+}
+
+int Board::filledCount() const
+{
+    return static_cast<int>(std::count_if(m_cells.begin(), m_cells.end(),
+                                          [](char value) { return value != 0; }));
+}
+
+bool Board::isComplete() const
+{
+    return isValid() && std::find(m_cells.begin(), m_cells.end(), '\0') == m_cells.end();
+}
+
+int Board::at(int row, int col) const
+{
+    const int side = size();
+    if (row < 0 || row >= side || col < 0 || col >= side) {
+        return 0;
+    }
+    return cells()[row * side + col];
+}
+
+int Board::cell(int index) const
+{
+    return (index >= 0 && index < cellCount()) ? cells()[index] : 0;
+}
+
+QVariantList Board::toVariantList() const
+{
+    const int side = size();
+    const std::uint8_t *values = cells();
+    QVariantList rows;
+    rows.reserve(side);
+    for (int r = 0; r < side; ++r) {
+        QVariantList row;
+        row.reserve(side);
+        for (int c = 0; c < side; ++c) {
+            row.append(static_cast<int>(values[r * side + c]));
+        }
+        rows.append(QVariant(row));
+    }
+    return rows;
+}
+
+Board::Grid Board::toGrid() const
+{
+    const int side = size();
+    const std::uint8_t *values = cells();
+    Grid rows(side, std::vector<int>(side));
+    for (int cell = 0; cell < side * side; ++cell) {
+        rows[cell / side][cell % side] = values[cell];
+    }
+    return rows;
+}
+
+const std::uint8_t *Board::cells() const
+{
+    return reinterpret_cast<const std::uint8_t *>(m_cells.constData());
+}
+
+std::uint8_t *Board::cells()
+{
+    return reinterpret_cast<std::uint8_t *>(m_cells.data());
+}
+
+bool Board::operator==(const Board &other) const
+{
+    return m_boxSize == other.m_boxSize && m_cells == other.m_cells;
+}
+
+bool Board::operator!=(const Board &other) const
+{
+    return !(*this == other);
+}
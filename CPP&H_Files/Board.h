@@ -0,0 +1,110 @@
+/**
+ * @file Board.h
+ * @brief Header file for the Board value type, the grid passed between C++ and QML
+ *
+ * This class is responsible for:
+ * - Holding one square grid as a single byte per cell
+ * - Crossing the QML boundary and queued signals as one implicitly shared
+ *   buffer instead of a nested list of boxed ints
+ * - Converting to and from the QVariantList rows older callers still use
+ */
+
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <QByteArray>
+#include <QMetaType>
+#include <QVariantList>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class Board
+ * @brief Read-only value type of a square grid, 0 for empty cells
+ *
+ * Cells are stored row-major, one byte each, in a QByteArray: a 9x9 board
+ * is 81 bytes in one allocation, and copying it (into a QVariant, a signal
+ * argument or a queued call) only bumps a reference count. Writing through
+ * cells() detaches the copy being written.
+ *
+ * A default-constructed board, or one converted from malformed input, is
+ * invalid: it has no cells and every API taking it rejects it the way it
+ * rejects a wrongly shaped list.
+ */
+class Board
+{
+    Q_GADGET
+    Q_PROPERTY(bool valid READ isValid)
+    Q_PROPERTY(int boxSize READ boxSize)
+    Q_PROPERTY(int size READ size)
+    Q_PROPERTY(int filledCount READ filledCount)
+
+public:
+    using Grid = std::vector<std::vector<int>>;
+
+    /** @brief Invalid board */
+    Board() = default;
+
+    /**
+     * @brief Empty board
+     * @param boxSize 2 (4x4) to 5 (25x25); anything else gives an invalid board
+     */
+    explicit Board(int boxSize);
+
+    /**
+     * @brief Board from rows
+     * @return Invalid if the grid is not a supported square or a value is
+     *         outside 0..size
+     */
+    static Board fromGrid(const Grid &grid);
+
+    /** @brief fromGrid for QVariantList rows, as QML arrays arrive */
+    static Board fromVariantList(const QVariantList &rows);
+
+    /** @brief Whether the board has cells */
+    bool isValid() const;
+
+    /** @brief Side of one box, 0 when invalid */
+    int boxSize() const;
+
+    /** @brief Cells per row and column */
+    int size() const;
+
+    /** @brief Number of cells */
+    int cellCount() const;
+
+    /** @brief Cells holding a digit */
+    int filledCount() const;
+
+    /** @brief Whether every cell holds a digit (false when invalid) */
+    bool isComplete() const;
+
+    /** @brief Digit at a position, 0 if empty or out of range */
+    Q_INVOKABLE int at(int row, int col) const;
+
+    /** @brief Digit in a cell by row-major index, 0 if empty or out of range */
+    Q_INVOKABLE int cell(int index) const;
+
+    /** @brief The rows as QVariantList, for list-based callers */
+    Q_INVOKABLE QVariantList toVariantList() const;
+
+    /** @brief The rows as vectors */
+    Grid toGrid() const;
+
+    /** @brief Row-major cells; cellCount() bytes */
+    const std::uint8_t *cells() const;
+
+    /** @brief Writable cells; detaches from other copies */
+    std::uint8_t *cells();
+
+    bool operator==(const Board &other) const;
+    bool operator!=(const Board &other) const;
+
+private:
+    QByteArray m_cells;
+    int m_boxSize = 0;
+};
+
+Q_DECLARE_METATYPE(Board)
+
+#endif // BOARD_H
@@ -0,0 +1,244 @@
+/**
+ * @file BoardModel.cpp
+ * @brief Implementation of the BoardModel class
+ */
+
+#include "BoardModel.h"
+#include <algorithm>
+
+/**
+ * Constructor for BoardModel
+ * Starts as an empty 9x9 board
+ */
+BoardModel::BoardModel(QObject *parent)
+    : QAbstractListModel(parent),
+      m_filled(0)
+{
+    resetCells(3);
+}
+
+int BoardModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_values.cellCount();
+}
+
+QVariant BoardModel::data(const QModelIndex &index, int role) const
+{
+    const int cell = index.row();
+    if (!index.isValid() || !validCell(cell)) {
+        return QVariant();
+    }
+
+    switch (role) {
+    case ValueRole:
+        return m_values.cell(cell);
+    case GivenRole:
+        return (m_flags[cell] & Given) != 0;
+    case CorrectRole:
+        return (m_flags[cell] & Correct) != 0;
+    case NotesRole:
+        return static_cast<int>(m_notes[cell]);
+    case RowRole:
+        return cell / size();
+    case ColumnRole:
+        return cell % size();
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> BoardModel::roleNames() const
+{
+    return {
+        {ValueRole, "value"},
+        {GivenRole, "given"},
+        {CorrectRole, "correct"},
+        {NotesRole, "notes"},
+        {RowRole, "row"},
+        {ColumnRole, "column"},
+    };
+}
+
+int BoardModel::boxSize() const
+{
+    return m_values.boxSize();
+}
+
+void BoardModel::setBoxSize(int boxSize)
+{
+    if (boxSize < 2 || boxSize > 5 || boxSize == m_values.boxSize()) {
+        return;
+    }
+    beginResetModel();
+    resetCells(boxSize);
+    endResetModel();
+    emit boxSizeChanged();
+    emit filledCountChanged();
+}
+
+int BoardModel::size() const
+{
+    return m_values.size();
+}
+
+int BoardModel::filledCount() const
+{
+    return m_filled;
+}
+
+void BoardModel::setValue(int cell, int value)
+{
+    if (!validCell(cell) || value < 0 || value > size() || (m_flags[cell] & Given)) {
+        return;
+    }
+    const int old = m_values.cell(cell);
+    if (old == value && m_notes[cell] == 0) {
+        return;
+    }
+
+    m_values.cells()[cell] = static_cast<std::uint8_t>(value);
+    m_flags[cell] &= static_cast<std::uint8_t>(~Correct);
+    m_notes[cell] = 0;
+    cellChanged(cell, {ValueRole, CorrectRole, NotesRole});
+    addFilled((value != 0) - (old != 0));
+}
+
+int BoardModel::value(int cell) const
+{
+    return m_values.cell(cell);
+}
+
+bool BoardModel::isGiven(int cell) const
+{
+    return validCell(cell) && (m_flags[cell] & Given);
+}
+
+void BoardModel::setCorrect(int cell, bool correct)
+{
+    if (!validCell(cell) || ((m_flags[cell] & Correct) != 0) == correct) {
+        return;
+    }
+    m_flags[cell] ^= Correct;
+    cellChanged(cell, {CorrectRole});
+}
+
+void BoardModel::toggleNote(int cell, int digit)
+{
+    if (!validCell(cell) || digit < 1 || digit > size() || m_values.cell(cell) != 0) {
+        return;
+    }
+    m_notes[cell] ^= std::uint32_t(1) << (digit - 1);
+    cellChanged(cell, {NotesRole});
+}
+
+void BoardModel::loadPuzzle(QVariantList puzzle)
+{
+    loadPuzzle(Board::fromVariantList(puzzle));
+}
+
+bool BoardModel::loadPuzzle(const Board &puzzle)
+{
+    if (puzzle.boxSize() != boxSize()) {
+        return false;
+    }
+
+    // The givens are the puzzle's cells as they are; share them
+    m_values = puzzle;
+    const std::uint8_t *values = m_values.cells();
+    int filled = 0;
+    for (int cell = 0; cell < m_values.cellCount(); ++cell) {
+        const bool given = values[cell] != 0;
+        m_flags[cell] = given ? Given : 0;
+        m_notes[cell] = 0;
+        filled += given;
+    }
+    emit dataChanged(index(0), index(m_values.cellCount() - 1));
+    addFilled(filled - m_filled);
+    return true;
+}
+
+void BoardModel::clearEntries()
+{
+    int cleared = 0;
+    std::uint8_t *values = m_values.cells();
+    for (int cell = 0; cell < m_values.cellCount(); ++cell) {
+        if (!(m_flags[cell] & Given)) {
+            cleared += values[cell] != 0;
+            values[cell] = 0;
+            m_flags[cell] = 0;
+            m_notes[cell] = 0;
+        }
+    }
+    emit dataChanged(index(0), index(m_values.cellCount() - 1),
+                     {ValueRole, CorrectRole, NotesRole});
+    addFilled(-cleared);
+}
+
+void BoardModel::clear()
+{
+    m_values = Board(boxSize());
+    std::fill(m_flags.begin(), m_flags.end(), 0);
+    std::fill(m_notes.begin(), m_notes.end(), 0);
+    emit dataChanged(index(0), index(m_values.cellCount() - 1));
+    addFilled(-m_filled);
+}
+
+QVariantList BoardModel::toVariantList() const
+{
+    return m_values.toVariantList();
+}
+
+Board BoardModel::board() const
+{
+    return m_values;
+}
+
+bool BoardModel::fillSolution(const Board &solution)
+{
+    if (solution.boxSize() != boxSize()) {
+        return false;
+    }
+
+    const std::uint8_t *digits = solution.cells();
+    std::uint8_t *values = m_values.cells();
+    int filled = 0;
+    for (int cell = 0; cell < m_values.cellCount(); ++cell) {
+        if (values[cell] == 0 && digits[cell] != 0) {
+            values[cell] = digits[cell];
+            m_flags[cell] |= Correct;
+            m_notes[cell] = 0;
+            ++filled;
+        }
+    }
+    emit dataChanged(index(0), index(m_values.cellCount() - 1), {ValueRole, CorrectRole, NotesRole});
+    addFilled(filled);
+    return true;
+}
+
+bool BoardModel::validCell(int cell) const
+{
+    return cell >= 0 && cell < m_values.cellCount();
+}
+
+void BoardModel::resetCells(int boxSize)
+{
+    m_values = Board(boxSize);
+    const std::size_t cells = static_cast<std::size_t>(m_values.cellCount());
+    m_flags.assign(cells, 0);
+    m_notes.assign(cells, 0);
+    m_filled = 0;
+}
+
+void BoardModel::cellChanged(int cell, const QVector<int> &roles)
+{
+    const QModelIndex changed = index(cell);
+    emit dataChanged(changed, changed, roles);
+}
+
+void BoardModel::addFilled(int delta)
+{
+    if (delta != 0) {
+        m_filled += delta;
+        emit filledCountChanged();
+    }
+}
@@ -0,0 +1,170 @@
+/**
+ * @file BoardModel.h
+ * @brief Header file for the BoardModel class, the board shown by the QML screens
+ *
+ * This class is responsible for:
+ * - Owning the cell values, givens, pencil marks and correctness flags
+ * - Exposing them to a QML Repeater or view as one row per cell
+ * - Reporting every change for just the cells and roles it touched
+ * - Handing the board to SudokuGenerator and Solver without conversion
+ */
+
+#ifndef BOARDMODEL_H
+#define BOARDMODEL_H
+
+#include <QAbstractListModel>
+#include <QVariantList>
+#include <QVector>
+#include <cstdint>
+#include <vector>
+#include "Board.h"
+
+/**
+ * @class BoardModel
+ * @brief Cell-per-row list model of one Sudoku board
+ *
+ * Cells are numbered row-major from 0. Givens cannot be overwritten or
+ * erased by setValue; only loadPuzzle and clear change them. Pencil marks
+ * are kept as a bitmask per cell (bit d-1 for digit d) and are dropped when
+ * the cell gets a value.
+ *
+ * The screens bind their cells to the roles and call SudokuGenerator and
+ * Solver with the model itself, so no QML code walks the grid to collect
+ * it. The values are kept in a Board, which board() hands out without
+ * copying the cells. The QVariantList functions remain for code that still
+ * passes nested lists.
+ */
+class BoardModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int boxSize READ boxSize WRITE setBoxSize NOTIFY boxSizeChanged)
+    Q_PROPERTY(int size READ size NOTIFY boxSizeChanged)
+    Q_PROPERTY(int filledCount READ filledCount NOTIFY filledCountChanged)
+
+public:
+    /** @brief Data roles of a cell */
+    enum Roles {
+        ValueRole = Qt::UserRole + 1, ///< "value": digit, 0 when empty
+        GivenRole,                    ///< "given": part of the puzzle
+        CorrectRole,                  ///< "correct": confirmed against the solution
+        NotesRole,                    ///< "notes": pencil marks, bit d-1 for digit d
+        RowRole,                      ///< "row"
+        ColumnRole                    ///< "column"
+    };
+    Q_ENUM(Roles)
+
+    explicit BoardModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    /** @brief Side of one box */
+    int boxSize() const;
+
+    /**
+     * @brief Resizes the board; every cell is cleared
+     * @param boxSize 2 (4x4) to 5 (25x25); other values are ignored
+     */
+    void setBoxSize(int boxSize);
+
+    /** @brief Cells per row and column */
+    int size() const;
+
+    /** @brief Cells holding a digit, givens included */
+    int filledCount() const;
+
+    /**
+     * @brief Enters or erases a digit; ignored for givens and bad input
+     * @param cell Cell index
+     * @param value Digit, or 0 to erase
+     *
+     * Clears the cell's pencil marks and its correctness flag.
+     */
+    Q_INVOKABLE void setValue(int cell, int value);
+
+    /** @brief Digit in a cell, 0 if empty or out of range */
+    Q_INVOKABLE int value(int cell) const;
+
+    /** @brief Whether a cell is one of the puzzle's givens */
+    Q_INVOKABLE bool isGiven(int cell) const;
+
+    /**
+     * @brief Marks a cell as checked against the solution or not
+     * @param cell Cell index
+     * @param correct New flag
+     */
+    Q_INVOKABLE void setCorrect(int cell, bool correct);
+
+    /**
+     * @brief Adds or removes one pencil mark of an empty cell
+     * @param cell Cell index
+     * @param digit Digit to toggle (1 to size)
+     */
+    Q_INVOKABLE void toggleNote(int cell, int digit);
+
+    /**
+     * @brief Starts a new puzzle: non-zero cells become givens, the rest
+     * are emptied
+     * @param puzzle Board whose box size must be boxSize()
+     * @return False (and no change) if it is not
+     */
+    Q_INVOKABLE bool loadPuzzle(const Board &puzzle);
+
+    /**
+     * @brief loadPuzzle for QVariantList rows
+     * @param puzzle Square grid; its side must be size() or the call is ignored
+     */
+    Q_INVOKABLE void loadPuzzle(QVariantList puzzle);
+
+    /** @brief Empties every cell that is not a given */
+    Q_INVOKABLE void clearEntries();
+
+    /** @brief Empties every cell, givens included */
+    Q_INVOKABLE void clear();
+
+    /** @brief The values as QVariantList rows, for list-based callers */
+    Q_INVOKABLE QVariantList toVariantList() const;
+
+    /** @brief The values; shares the model's cells until either side changes */
+    Q_INVOKABLE Board board() const;
+
+    /**
+     * @brief Fills the empty cells from a solution and marks them correct,
+     * with a single dataChanged for the whole board
+     * @return False (and no change) if the box size differs from boxSize()
+     */
+    bool fillSolution(const Board &solution);
+
+signals:
+    /** @brief Emitted when the board is resized */
+    void boxSizeChanged();
+
+    /** @brief Emitted when a cell changes between empty and filled */
+    void filledCountChanged();
+
+private:
+    /** @brief Per-cell flag bits */
+    enum Flag : std::uint8_t {
+        Given = 1,
+        Correct = 2
+    };
+
+    bool validCell(int cell) const;
+
+    /** @brief Resizes the storage and empties it (inside a model reset) */
+    void resetCells(int boxSize);
+
+    /** @brief Signals one cell's roles */
+    void cellChanged(int cell, const QVector<int> &roles);
+
+    /** @brief Adds delta to the filled count and signals it */
+    void addFilled(int delta);
+
+    int m_filled;
+    Board m_values;
+    std::vector<std::uint8_t> m_flags;
+    std::vector<std::uint32_t> m_notes;
+};
+
+#endif // BOARDMODEL_H
@@ -0,0 +1,355 @@
+/**
+ * @file CanonicalForm.h
+ * @brief Header-only canonical form and hash of Sudoku puzzles, templated on the box size
+ *
+ * This header is responsible for:
+ * - Mapping every puzzle that differs from another only by relabelled
+ *   digits, permuted rows, columns, bands or stacks, transposition or
+ *   rotation to one representative
+ * - Hashing that representative to 64 bits for fast duplicate lookups
+ */
+
+#ifndef CANONICALFORM_H
+#define CANONICALFORM_H
+
+#include "SudokuEngine.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class CanonicalForm
+ * @brief Minimal lexicographic form under the full Sudoku symmetry group
+ *
+ * The group is generated by transposition, band and stack permutations,
+ * row permutations within a band, column permutations within a stack and
+ * digit relabelling; rotations and reflections are compositions of these.
+ *
+ * A puzzle's form is taken from its solution grid: the grid is transformed
+ * to its lexicographically smallest image, and among the transformations
+ * that reach it (more than one only for grids with automorphisms) the one
+ * that puts blanks earliest decides where the givens go. Since a unique
+ * puzzle determines its solution, two puzzles have the same form exactly
+ * when one is a transformed copy of the other.
+ *
+ * In the smallest image the first row is always 1..N (digits are labelled
+ * by where they sit in it), so every later cell is "the output column of
+ * this digit in row one". The search fixes the first row, then fills the
+ * remaining rows cell by cell and places each column only when a cell
+ * first needs it, abandoning a branch as soon as its prefix is larger than
+ * the best image found. A 9x9 grid takes well under 0.1 ms.
+ */
+template <int BoxSize>
+class CanonicalForm
+{
+public:
+    using Engine = SudokuEngine<BoxSize>;
+    using Cells = typename Engine::Cells;
+
+    static constexpr int GRID_SIZE = Engine::GRID_SIZE;
+    static constexpr int CELL_COUNT = Engine::CELL_COUNT;
+
+    /**
+     * @brief Computes the canonical form of a puzzle
+     * @param solution Complete valid grid
+     * @param givens Clues (0: blank); each must match solution. Pass the
+     *        solution itself for the form of the grid alone
+     * @param form Receives the relabelled, rearranged givens
+     * @return False if solution is not a complete valid grid or a given
+     *         disagrees with it; form is then left unchanged
+     */
+    static bool canonicalize(const Cells &solution, const Cells &givens, Cells &form)
+    {
+        typename Engine::State state;
+        if (!Engine::load(solution, state, false)) {
+            return false;
+        }
+        for (int i = 0; i < CELL_COUNT; ++i) {
+            if (solution[i] == 0 || (givens[i] != 0 && givens[i] != solution[i])) {
+                return false;
+            }
+        }
+
+        Search search(solution);
+        search.run();
+
+        // Break ties between automorphic images by the givens pattern
+        bool first = true;
+        for (const Transform &transform : search.ties) {
+            Cells candidate;
+            for (int i = 0; i < GRID_SIZE; ++i) {
+                for (int j = 0; j < GRID_SIZE; ++j) {
+                    const int k = i * GRID_SIZE + j;
+                    const int r = transform.rows[i];
+                    const int c = transform.cols[j];
+                    const int source = transform.transpose ? c * GRID_SIZE + r : r * GRID_SIZE + c;
+                    candidate[k] = givens[source] != 0 ? search.best[k] : 0;
+                }
+            }
+            if (first || candidate < form) {
+                form = candidate;
+                first = false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief 64-bit FNV-1a hash of a form (or of any cells)
+     * @param form Cells to hash; the grid size is mixed in, so forms of
+     *        different box sizes never collide by construction
+     */
+    static std::uint64_t hash(const Cells &form)
+    {
+        std::uint64_t h = 0xcbf29ce484222325ULL;
+        h = (h ^ static_cast<std::uint64_t>(GRID_SIZE)) * 0x100000001b3ULL;
+        for (std::uint8_t cell : form) {
+            h = (h ^ cell) * 0x100000001b3ULL;
+        }
+        return h;
+    }
+
+private:
+    /** @brief Rearrangement that maps the source grid to an image */
+    struct Transform {
+        bool transpose;
+        std::array<std::int8_t, GRID_SIZE> rows;   ///< Output row -> source row
+        std::array<std::int8_t, GRID_SIZE> cols;   ///< Output column -> source column
+    };
+
+    /** @brief Branch-and-bound search for the smallest image */
+    struct Search {
+        explicit Search(const Cells &solution)
+        {
+            for (int r = 0; r < GRID_SIZE; ++r) {
+                for (int c = 0; c < GRID_SIZE; ++c) {
+                    grids[0][r * GRID_SIZE + c] = solution[r * GRID_SIZE + c];
+                    grids[1][r * GRID_SIZE + c] = solution[c * GRID_SIZE + r];
+                }
+            }
+            best.fill(GRID_SIZE + 1); // Larger than any image
+            for (int j = 0; j < GRID_SIZE; ++j) {
+                best[j] = static_cast<std::uint8_t>(j + 1);
+                out[j] = static_cast<std::uint8_t>(j + 1);
+            }
+            rowAt.fill(-1);
+            colAt.fill(-1);
+            posOf.fill(-1);
+            stackAt.fill(-1);
+            blockOf.fill(-1);
+            bandAt.fill(-1);
+        }
+
+        /** @brief Tries every orientation and first row */
+        void run()
+        {
+            for (transpose = 0; transpose < 2; ++transpose) {
+                src = grids[transpose].data();
+                for (int r = 0; r < GRID_SIZE; ++r) {
+                    for (int c = 0; c < GRID_SIZE; ++c) {
+                        pos0[src[r * GRID_SIZE + c]] = static_cast<std::int8_t>(c);
+                    }
+                    bandAt[0] = static_cast<std::int8_t>(r / BoxSize);
+                    rowAt[0] = static_cast<std::int8_t>(r);
+                    rowsUsed = 1u << r;
+                    bandsUsed = 1u << (r / BoxSize);
+                    visit(GRID_SIZE, false); // Row one always equals best's
+                }
+            }
+        }
+
+        /**
+         * @brief Runs visit(k, childLess) for one of several sibling branches
+         *
+         * A new best found inside the branch shares the current prefix, so
+         * once that happens the prefix is no longer smaller than best for
+         * the remaining siblings and less is cleared.
+         */
+        void descend(int k, bool childLess, bool &less)
+        {
+            const std::uint64_t before = improvements;
+            visit(k, childLess);
+            if (improvements != before) {
+                less = false;
+            }
+        }
+
+        /**
+         * @brief Fills output cell k and everything after it
+         * @param less Whether the prefix before k is already smaller than best
+         */
+        void visit(int k, bool less)
+        {
+            if (k == CELL_COUNT) {
+                if (less) {
+                    best = out;
+                    ties.clear();
+                    ++improvements;
+                }
+                ties.push_back({transpose != 0, rowAt, colAt});
+                return;
+            }
+
+            const int i = k / GRID_SIZE;
+            const int j = k % GRID_SIZE;
+            if (rowAt[i] < 0) {
+                chooseRow(k, less);
+                return;
+            }
+            if (colAt[j] < 0) {
+                for (int c = 0; c < GRID_SIZE; ++c) {
+                    if (posOf[c] < 0 && allowed(c, j)) {
+                        const bool opened = place(c, j);
+                        descend(k, less, less);
+                        unplace(c, j, opened);
+                    }
+                }
+                return;
+            }
+
+            // The cell's value is the output column of its digit in row one
+            const int target = pos0[src[rowAt[i] * GRID_SIZE + colAt[j]]];
+            if (posOf[target] >= 0) {
+                const int value = posOf[target] + 1;
+                if (less || value <= best[k]) {
+                    out[k] = static_cast<std::uint8_t>(value);
+                    visit(k + 1, less || value < best[k]);
+                }
+                return;
+            }
+            for (int p = j + 1; p < GRID_SIZE; ++p) {
+                if (colAt[p] >= 0 || !allowed(target, p)) {
+                    continue;
+                }
+                const int value = p + 1;
+                if (!less && value > best[k]) {
+                    break; // Later positions are larger still
+                }
+                const bool opened = place(target, p);
+                out[k] = static_cast<std::uint8_t>(value);
+                descend(k + 1, less || value < best[k], less);
+                unplace(target, p, opened);
+            }
+        }
+
+        /**
+         * @brief Picks the source row for the output row starting at k
+         *
+         * Row one places every column, so from row two on each candidate
+         * row has a fixed image. Distinct rows have distinct images, so
+         * only the smallest one can lead to best and there is no branching.
+         */
+        void chooseRow(int k, bool less)
+        {
+            const int i = k / GRID_SIZE;
+            const int outBand = i / BoxSize;
+            const bool newBand = i % BoxSize == 0;
+            const auto candidate = [this, outBand, newBand](int r) {
+                return (rowsUsed >> r & 1u) == 0 &&
+                       (newBand ? (bandsUsed >> (r / BoxSize) & 1u) == 0 : r / BoxSize == bandAt[outBand]);
+            };
+
+            if (i < 2) {
+                for (int r = 0; r < GRID_SIZE; ++r) {
+                    if (candidate(r)) {
+                        select(i, r, newBand);
+                        descend(k, less, less);
+                        deselect(i, r, newBand);
+                    }
+                }
+                return;
+            }
+
+            int chosen = -1;
+            std::array<std::uint8_t, GRID_SIZE> smallest{};
+            for (int r = 0; r < GRID_SIZE; ++r) {
+                if (!candidate(r)) {
+                    continue;
+                }
+                std::array<std::uint8_t, GRID_SIZE> image;
+                for (int j = 0; j < GRID_SIZE; ++j) {
+                    image[j] = static_cast<std::uint8_t>(posOf[pos0[src[r * GRID_SIZE + colAt[j]]]] + 1);
+                }
+                if (chosen < 0 || image < smallest) {
+                    chosen = r;
+                    smallest = image;
+                }
+            }
+            select(i, chosen, newBand);
+            visit(k, less);
+            deselect(i, chosen, newBand);
+        }
+
+        /** @brief Uses source row r as output row i */
+        void select(int i, int r, bool newBand)
+        {
+            rowAt[i] = static_cast<std::int8_t>(r);
+            rowsUsed |= 1u << r;
+            if (newBand) {
+                bandAt[i / BoxSize] = static_cast<std::int8_t>(r / BoxSize);
+                bandsUsed |= 1u << (r / BoxSize);
+            }
+        }
+
+        void deselect(int i, int r, bool newBand)
+        {
+            rowAt[i] = -1;
+            rowsUsed &= ~(1u << r);
+            if (newBand) {
+                bandAt[i / BoxSize] = -1;
+                bandsUsed &= ~(1u << (r / BoxSize));
+            }
+        }
+
+        /** @brief Whether source column c may go to output column p */
+        bool allowed(int c, int p) const
+        {
+            const int stack = c / BoxSize;
+            const int block = p / BoxSize;
+            return stackAt[block] < 0 ? blockOf[stack] < 0 : stackAt[block] == stack;
+        }
+
+        /** @brief Puts c at p; returns whether that opened p's block for c's stack */
+        bool place(int c, int p)
+        {
+            colAt[p] = static_cast<std::int8_t>(c);
+            posOf[c] = static_cast<std::int8_t>(p);
+            const int block = p / BoxSize;
+            if (stackAt[block] >= 0) {
+                return false;
+            }
+            stackAt[block] = static_cast<std::int8_t>(c / BoxSize);
+            blockOf[c / BoxSize] = static_cast<std::int8_t>(block);
+            return true;
+        }
+
+        void unplace(int c, int p, bool opened)
+        {
+            colAt[p] = -1;
+            posOf[c] = -1;
+            if (opened) {
+                stackAt[p / BoxSize] = -1;
+                blockOf[c / BoxSize] = -1;
+            }
+        }
+
+        std::array<Cells, 2> grids;                 ///< Source grid, plain and transposed
+        const std::uint8_t *src = nullptr;          ///< The one in use
+        int transpose = 0;
+        std::array<std::int8_t, GRID_SIZE + 1> pos0{}; ///< Digit -> source column in the first row
+        std::array<std::int8_t, GRID_SIZE> rowAt;   ///< Output row -> source row (-1: open)
+        std::array<std::int8_t, GRID_SIZE> colAt;   ///< Output column -> source column (-1: open)
+        std::array<std::int8_t, GRID_SIZE> posOf;   ///< Source column -> output column (-1: open)
+        std::array<std::int8_t, BoxSize> stackAt;   ///< Output stack -> source stack
+        std::array<std::int8_t, BoxSize> blockOf;   ///< Source stack -> output stack
+        std::array<std::int8_t, BoxSize> bandAt;    ///< Output band -> source band
+        std::uint32_t rowsUsed = 0;
+        std::uint32_t bandsUsed = 0;
+        std::uint64_t improvements = 0;             ///< Times best was replaced
+        Cells out{};                                ///< Image being built
+        Cells best;                                 ///< Smallest image so far
+        std::vector<Transform> ties;                ///< Every transformation reaching best
+    };
+};
+
+#endif // CANONICALFORM_H
@@ -0,0 +1,247 @@
+/**
+ * @file DlxSolver.cpp
+ * @brief Implementation of the DlxSolver class
+ */
+
+#include "DlxSolver.h"
+#include <cstddef>
+
+namespace {
+
+// Column groups of the exact-cover matrix, 81 columns each (9 per diagonal)
+constexpr int kCellColumns = 0;
+constexpr int kRowColumns = 81;
+constexpr int kColColumns = 162;
+constexpr int kBoxColumns = 243;
+constexpr int kMainDiagonalColumns = 324;
+constexpr int kAntiDiagonalColumns = 333;
+
+} // namespace
+
+/**
+ * Constructor for DlxSolver
+ * Builds the 729-row matrix once; headers are numbered from 1
+ */
+DlxSolver::DlxSolver(bool diagonal)
+    : m_diagonal(diagonal),
+      m_columnCount(diagonal ? kAntiDiagonalColumns + 9 : kMainDiagonalColumns)
+{
+    // 4 nodes per row, plus up to 2 diagonal nodes on diagonal cells
+    const int nodeEstimate = 1 + m_columnCount + 729 * 6;
+    m_left.reserve(nodeEstimate);
+    m_right.reserve(nodeEstimate);
+    m_up.reserve(nodeEstimate);
+    m_down.reserve(nodeEstimate);
+    m_column.reserve(nodeEstimate);
+    m_rowId.reserve(nodeEstimate);
+
+    // Root and column headers in one circular horizontal list
+    for (int i = 0; i <= m_columnCount; ++i) {
+        m_left.push_back(i == 0 ? m_columnCount : i - 1);
+        m_right.push_back(i == m_columnCount ? 0 : i + 1);
+        m_up.push_back(i);
+        m_down.push_back(i);
+        m_column.push_back(i);
+        m_rowId.push_back(-1);
+    }
+    m_size.assign(m_columnCount + 1, 0);
+
+    std::vector<int> columns;
+    columns.reserve(6);
+    for (int cell = 0; cell < 81; ++cell) {
+        const int r = cell / 9;
+        const int c = cell % 9;
+        const int b = (r / 3) * 3 + c / 3;
+        for (int d = 0; d < 9; ++d) {
+            columns.clear();
+            columns.push_back(1 + kCellColumns + cell);
+            columns.push_back(1 + kRowColumns + r * 9 + d);
+            columns.push_back(1 + kColColumns + c * 9 + d);
+            columns.push_back(1 + kBoxColumns + b * 9 + d);
+            if (m_diagonal && r == c) {
+                columns.push_back(1 + kMainDiagonalColumns + d);
+            }
+            if (m_diagonal && r + c == 8) {
+                columns.push_back(1 + kAntiDiagonalColumns + d);
+            }
+            addRow(cell * 9 + d, columns);
+        }
+    }
+
+    m_partial.reserve(81);
+}
+
+/**
+ * Appends a row: nodes are linked into a horizontal ring and appended at the
+ * bottom of each column's vertical ring
+ */
+void DlxSolver::addRow(int rowId, const std::vector<int> &columns)
+{
+    const int first = static_cast<int>(m_column.size());
+    m_rowStart[rowId] = first;
+
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        const int node = first + static_cast<int>(i);
+        const int col = columns[i];
+
+        m_left.push_back(i == 0 ? first + static_cast<int>(columns.size()) - 1 : node - 1);
+        m_right.push_back(i + 1 == columns.size() ? first : node + 1);
+        m_up.push_back(m_up[col]);
+        m_down.push_back(col);
+        m_down[m_up[col]] = node;
+        m_up[col] = node;
+        m_column.push_back(col);
+        m_rowId.push_back(rowId);
+        ++m_size[col];
+    }
+}
+
+/**
+ * Solves a puzzle by covering the givens' rows and running Algorithm X
+ * The matrix is fully restored before returning, whatever the outcome
+ */
+bool DlxSolver::solve(const Cells &givens, Cells &solution, std::int64_t maxNodes, std::int64_t &nodes,
+                      const InterruptCheck &interrupt)
+{
+    m_maxNodes = maxNodes;
+    m_interrupt = interrupt ? &interrupt : nullptr;
+    m_nodes = 0;
+    m_partial.clear();
+
+    // Select each given's row; a column that is already gone means a conflict
+    std::vector<int> selected;
+    selected.reserve(81);
+    bool consistent = true;
+    for (int cell = 0; cell < 81 && consistent; ++cell) {
+        if (givens[cell] == 0) {
+            continue;
+        }
+        const int rowNode = m_rowStart[cell * 9 + givens[cell] - 1];
+        int node = rowNode;
+        do {
+            const int col = m_column[node];
+            if (m_right[m_left[col]] != col) {
+                consistent = false;
+                break;
+            }
+            node = m_right[node];
+        } while (node != rowNode);
+
+        if (consistent) {
+            node = rowNode;
+            do {
+                cover(m_column[node]);
+                node = m_right[node];
+            } while (node != rowNode);
+            selected.push_back(rowNode);
+        }
+    }
+
+    const bool found = consistent && search();
+    if (found) {
+        solution = givens;
+        for (int node : m_partial) {
+            solution[m_rowId[node] / 9] = static_cast<std::uint8_t>(m_rowId[node] % 9 + 1);
+        }
+    }
+
+    // Undo the search path and the givens, last covered first
+    for (auto it = m_partial.rbegin(); it != m_partial.rend(); ++it) {
+        for (int node = m_left[*it]; node != *it; node = m_left[node]) {
+            uncover(m_column[node]);
+        }
+        uncover(m_column[*it]);
+    }
+    m_partial.clear();
+    for (auto it = selected.rbegin(); it != selected.rend(); ++it) {
+        int node = m_left[*it];
+        do {
+            uncover(m_column[node]);
+            node = m_left[node];
+        } while (node != m_left[*it]);
+    }
+
+    m_interrupt = nullptr;
+    nodes = m_nodes;
+    return found;
+}
+
+/**
+ * Algorithm X: pick the column with the fewest rows, try each row in turn
+ * On success the chosen rows are left covered in m_partial for solve() to read
+ */
+bool DlxSolver::search()
+{
+    if (m_right[0] == 0) {
+        return true; // Every constraint satisfied
+    }
+    if (m_nodes++ > m_maxNodes) {
+        return false;
+    }
+    if (m_interrupt && m_nodes % CHECK_INTERVAL == 0 && (*m_interrupt)(m_nodes)) {
+        return false;
+    }
+
+    // Most constrained column (S heuristic)
+    int best = m_right[0];
+    for (int col = m_right[best]; col != 0 && m_size[best] > 1; col = m_right[col]) {
+        if (m_size[col] < m_size[best]) {
+            best = col;
+        }
+    }
+    if (m_size[best] == 0) {
+        return false;
+    }
+
+    cover(best);
+    for (int row = m_down[best]; row != best; row = m_down[row]) {
+        m_partial.push_back(row);
+        for (int node = m_right[row]; node != row; node = m_right[node]) {
+            cover(m_column[node]);
+        }
+
+        if (search()) {
+            return true;
+        }
+
+        for (int node = m_left[row]; node != row; node = m_left[node]) {
+            uncover(m_column[node]);
+        }
+        m_partial.pop_back();
+    }
+    uncover(best);
+    return false;
+}
+
+/**
+ * Removes a column from the header list and every conflicting row from
+ * the other columns it touches
+ */
+void DlxSolver::cover(int column)
+{
+    m_right[m_left[column]] = m_right[column];
+    m_left[m_right[column]] = m_left[column];
+    for (int row = m_down[column]; row != column; row = m_down[row]) {
+        for (int node = m_right[row]; node != row; node = m_right[node]) {
+            m_down[m_up[node]] = m_down[node];
+            m_up[m_down[node]] = m_up[node];
+            --m_size[m_column[node]];
+        }
+    }
+}
+
+/**
+ * Relinks everything cover() removed, in exactly the reverse order
+ */
+void DlxSolver::uncover(int column)
+{
+    for (int row = m_up[column]; row != column; row = m_up[row]) {
+        for (int node = m_left[row]; node != row; node = m_left[node]) {
+            ++m_size[m_column[node]];
+            m_down[m_up[node]] = node;
+            m_up[m_down[node]] = node;
+        }
+    }
+    m_right[m_left[column]] = column;
+    m_left[m_right[column]] = column;
+}
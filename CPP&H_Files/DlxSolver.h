@@ -0,0 +1,102 @@
+/**
+ * @file DlxSolver.h
+ * @brief Header file for the DlxSolver class, a Dancing Links exact-cover engine
+ *
+ * This class is responsible for:
+ * - Modelling Sudoku (optionally X-Sudoku) as an exact-cover matrix
+ * - Solving it with Knuth's Algorithm X on a Dancing Links structure
+ * - Reusing the same matrix across solves (givens are covered, then restored)
+ */
+
+#ifndef DLXSOLVER_H
+#define DLXSOLVER_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * @class DlxSolver
+ * @brief Algorithm X over a prebuilt Dancing Links matrix
+ *
+ * The matrix has one row per (cell, digit) choice and one column per
+ * constraint: cell filled, digit in row, digit in column, digit in box and,
+ * when diagonal checking is on, digit on each main diagonal. It is built once
+ * in the constructor; every solve covers the givens, searches, and uncovers
+ * everything again so the links are back in their pristine state.
+ */
+class DlxSolver
+{
+public:
+    /** @brief Flat row-major board, 0 for empty cells */
+    using Cells = std::array<std::uint8_t, 81>;
+
+    /** @brief Polled with the node count every CHECK_INTERVAL nodes; true aborts */
+    using InterruptCheck = std::function<bool(std::int64_t nodes)>;
+
+    /** @brief Nodes between two interrupt checks */
+    static constexpr std::int64_t CHECK_INTERVAL = 1024;
+
+    /**
+     * @brief Builds the exact-cover matrix
+     * @param diagonal True to add the two diagonal constraint column groups
+     */
+    explicit DlxSolver(bool diagonal = false);
+
+    /**
+     * @brief Whether this matrix includes the diagonal constraints
+     */
+    bool diagonal() const { return m_diagonal; }
+
+    /**
+     * @brief Solves a puzzle
+     * @param givens Puzzle to solve (0 represents empty cells)
+     * @param solution Receives the completed board on success
+     * @param maxNodes Search nodes allowed before giving up
+     * @param nodes Receives the number of search nodes visited
+     * @param interrupt Optional cancellation/deadline hook
+     * @return True if a solution was found within the node budget
+     */
+    bool solve(const Cells &givens, Cells &solution, std::int64_t maxNodes, std::int64_t &nodes,
+               const InterruptCheck &interrupt = InterruptCheck());
+
+private:
+    /**
+     * @brief Recursive Algorithm X search
+     * @return True once a full cover has been found
+     */
+    bool search();
+
+    /** @brief Unlink a column header and every row that uses it */
+    void cover(int column);
+
+    /** @brief Exact inverse of cover() */
+    void uncover(int column);
+
+    /**
+     * @brief Appends one matrix row covering the given columns
+     * @param rowId Choice encoded as cell * 9 + (digit - 1)
+     * @param columns Column headers this choice satisfies
+     */
+    void addRow(int rowId, const std::vector<int> &columns);
+
+    // Dancing Links storage: index 0 is the root, 1..m_columnCount are headers
+    std::vector<int> m_left;
+    std::vector<int> m_right;
+    std::vector<int> m_up;
+    std::vector<int> m_down;
+    std::vector<int> m_column;    ///< Header of each node
+    std::vector<int> m_rowId;     ///< Choice encoded by each node's row
+    std::vector<int> m_size;      ///< Live node count per column header
+    std::array<int, 729> m_rowStart{}; ///< First node of each choice row
+
+    std::vector<int> m_partial;   ///< Row nodes on the current search path
+    bool m_diagonal;
+    int m_columnCount;
+    std::int64_t m_maxNodes = 0;
+    std::int64_t m_nodes = 0;
+    const InterruptCheck *m_interrupt = nullptr; ///< Hook of the solve in progress
+};
+
+#endif // DLXSOLVER_H
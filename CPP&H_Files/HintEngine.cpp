@@ -0,0 +1,107 @@
+/**
+ * @file HintEngine.cpp
+ * @brief Implementation of the HintEngine class
+ */
+
+#include "HintEngine.h"
+#include "SudokuGrader.h"
+#include <algorithm>
+
+void HintEngine::reset(const Board &solution)
+{
+    m_solution = solution;
+    m_state = std::monostate();
+}
+
+bool HintEngine::nextHint(const Board &board, Hint &hint)
+{
+    hint = Hint();
+    if (!m_solution.isValid() || board.boxSize() != m_solution.boxSize()) {
+        return false;
+    }
+
+    bool ok = false;
+    dispatchBoxSize(m_solution.boxSize(), [&](auto boxSize) {
+        ok = nextHintFor<decltype(boxSize)::value>(board, hint);
+    });
+    return ok;
+}
+
+/**
+ * Checks the entries, brings the cached state up to date with the board and
+ * runs one grader step on a copy of it. Eliminations are kept in the cache;
+ * a placement is not, since it only becomes part of the board when the
+ * player enters it.
+ */
+template <int BoxSize>
+bool HintEngine::nextHintFor(const Board &board, Hint &hint)
+{
+    using Engine = SudokuEngine<BoxSize>;
+    using Grader = SudokuGrader<BoxSize>;
+    using State = typename Engine::State;
+
+    // Wrong entries first: logic built on them is worthless
+    typename Engine::Cells cells{};
+    const std::uint8_t *values = board.cells();
+    const std::uint8_t *solution = m_solution.cells();
+    for (int cell = 0; cell < Engine::CELL_COUNT; ++cell) {
+        if (values[cell] != 0 && values[cell] != solution[cell]) {
+            hint.kind = Kind::Mistake;
+            hint.cell = cell;
+            return true;
+        }
+    }
+    std::copy(values, values + Engine::CELL_COUNT, cells.begin());
+
+    // Place new entries; an erased or changed one means starting over
+    State *state = std::get_if<State>(&m_state);
+    bool reload = state == nullptr;
+    for (int cell = 0; state && cell < Engine::CELL_COUNT && !reload; ++cell) {
+        reload = state->cells[cell] != 0 && state->cells[cell] != cells[cell];
+    }
+    if (reload) {
+        State fresh;
+        if (!Engine::load(cells, fresh, false)) {
+            return false;
+        }
+        state = &m_state.template emplace<State>(fresh);
+    } else {
+        for (int cell = 0; cell < Engine::CELL_COUNT; ++cell) {
+            if (state->cells[cell] == 0 && cells[cell] != 0) {
+                Engine::place(*state, cell, cells[cell], false);
+            }
+        }
+    }
+    if (state->emptyCount == 0) {
+        return true;
+    }
+
+    State work = *state;
+    typename Grader::Step step;
+    if (Grader::nextStep(work, false, step)) {
+        hint.technique = static_cast<int>(step.technique);
+        hint.support = std::move(step.support);
+        if (step.cell >= 0) {
+            hint.kind = Kind::Placement;
+            hint.cell = step.cell;
+            hint.digit = step.digit;
+        } else {
+            hint.kind = Kind::Elimination;
+            for (const auto &elimination : step.eliminations) {
+                hint.eliminations.push_back({elimination.first, elimination.second});
+            }
+            *state = work;
+        }
+        return true;
+    }
+
+    // Logic stalled: give away the most constrained cell
+    int cell = -1;
+    typename Engine::Mask candidates = 0;
+    Engine::findEmptyCell(*state, cell, candidates);
+    hint.kind = Kind::Placement;
+    hint.technique = static_cast<int>(Grader::Technique::Guess);
+    hint.cell = cell;
+    hint.digit = solution[cell];
+    return true;
+}
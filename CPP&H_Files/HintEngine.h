@@ -0,0 +1,88 @@
+/**
+ * @file HintEngine.h
+ * @brief Header file for the HintEngine class, the source of in-game hints
+ *
+ * This class is responsible for:
+ * - Keeping the candidate state of the game in progress between hints
+ * - Updating that state cell by cell as the player enters digits
+ * - Finding the next logical step with SudokuGrader and reporting the
+ *   technique, the placement or eliminations and the supporting cells
+ */
+
+#ifndef HINTENGINE_H
+#define HINTENGINE_H
+
+#include "Board.h"
+#include "SudokuEngine.h"
+#include <cstdint>
+#include <utility>
+#include <variant>
+#include <vector>
+
+/**
+ * @class HintEngine
+ * @brief Next-step hints for one game at a time
+ *
+ * The candidate state is cached between calls: digits the player entered
+ * since the last hint are placed into it, and eliminations from earlier
+ * hints are kept, so a hint usually costs one grader step rather than a
+ * fresh analysis of the board. Erasing a digit invalidates what was
+ * derived from it, so the state is then rebuilt from the board.
+ *
+ * Entries that disagree with the solution are reported before any logic
+ * runs, since nothing deduced from a wrong digit can be trusted. When no
+ * technique applies, the hint reveals the solution digit of the most
+ * constrained empty cell. Not thread-safe; it belongs to the GUI thread.
+ */
+class HintEngine
+{
+public:
+    /** @brief What a hint asks the player to do */
+    enum class Kind {
+        None,        ///< The board is complete
+        Mistake,     ///< Clear the digit in cell
+        Placement,   ///< Enter digit in cell
+        Elimination  ///< Rule out the listed candidates
+    };
+
+    /** @brief One hint; cells are row-major indices */
+    struct Hint {
+        Kind kind = Kind::None;
+        int technique = -1; ///< SudokuGrader::Technique as int; -1 for None and Mistake
+        int cell = -1;      ///< Cell to fill (Placement) or clear (Mistake)
+        int digit = 0;      ///< Digit for that cell (Placement)
+        std::vector<std::pair<int, std::uint32_t>> eliminations; ///< Cells and the digits they lose (bit d-1)
+        std::vector<int> support; ///< Cells the step follows from
+    };
+
+    /**
+     * @brief Starts a new game
+     * @param solution Complete grid of the new puzzle (2x2 to 5x5 boxes)
+     */
+    void reset(const Board &solution);
+
+    /**
+     * @brief Finds the next step from the player's board
+     * @param board Current grid, 0 for empty cells
+     * @param hint Receives the step
+     * @return False if there is no game, or the board does not match the
+     *         solution's size or breaks the rules
+     */
+    bool nextHint(const Board &board, Hint &hint);
+
+private:
+    /** @brief nextHint for one box size */
+    template <int BoxSize>
+    bool nextHintFor(const Board &board, Hint &hint);
+
+    Board m_solution;
+
+    /** @brief Candidate state of the current game; empty until the first hint */
+    std::variant<std::monostate,
+                 SudokuEngine<2>::State,
+                 SudokuEngine<3>::State,
+                 SudokuEngine<4>::State,
+                 SudokuEngine<5>::State> m_state;
+};
+
+#endif // HINTENGINE_H
@@ -0,0 +1,277 @@
+/**
+ * @file HistoryIndex.cpp
+ * @brief Implementation of the HistoryIndex class
+ */
+
+#include "HistoryIndex.h"
+#include "CanonicalForm.h"
+#include "HistoryStore.h"
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+/** @brief Start of every index file ("SXIX") */
+constexpr quint32 INDEX_MAGIC = 0x58495853u;
+
+/** @brief Bumped whenever the file layout or the canonical form changes */
+constexpr quint32 INDEX_VERSION = 1;
+
+/** @brief Fixed part at the start of the index file */
+struct IndexHeader {
+    quint32 magic;
+    quint32 version;
+    qint64 historySize;   ///< Bytes of history the hashes describe
+};
+
+/** @brief Size of the history store, 0 if there is none */
+qint64 historySize(const QString &historyPath)
+{
+    const QFileInfo info(historyPath);
+    return info.exists() ? info.size() : 0;
+}
+
+} // namespace
+
+/**
+ * Constructor for HistoryIndex
+ * Only records the paths; build() does the reading
+ */
+HistoryIndex::HistoryIndex(const QString &historyPath)
+    : m_historyPath(historyPath),
+      m_indexPath(indexPathFor(historyPath)),
+      m_covered(0),
+      m_built(false)
+{
+}
+
+/**
+ * Reads the cached hashes when they still describe the history; otherwise
+ * the store is read once and the cache rewritten. Hashes inserted while
+ * this ran are kept, and force a rewrite since the cache lacks them.
+ */
+bool HistoryIndex::build(const std::atomic<bool> &stop)
+{
+    std::lock_guard<std::mutex> building(m_buildMutex);
+    if (isBuilt()) {
+        return true;
+    }
+
+    Hashes hashes;
+    qint64 covered = 0;
+    const bool cached = load(hashes, covered);
+    if (!cached && !rebuild(stop, hashes, covered)) {
+        return false;
+    }
+
+    bool insertedMeanwhile = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        insertedMeanwhile = !m_hashes.empty() || m_covered > covered;
+        m_hashes.insert(hashes.begin(), hashes.end());
+        m_covered = std::max(m_covered, covered);
+        m_built = true;
+    }
+    if (!cached || insertedMeanwhile) {
+        std::lock_guard<std::mutex> fileLock(m_fileMutex);
+        writeAll();
+    }
+    return true;
+}
+
+bool HistoryIndex::isBuilt() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_built;
+}
+
+bool HistoryIndex::contains(std::uint64_t hash) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hashes.count(hash) != 0;
+}
+
+void HistoryIndex::insert(std::uint64_t hash, qint64 historySize)
+{
+    record(&hash, historySize);
+}
+
+void HistoryIndex::skip(qint64 historySize)
+{
+    record(nullptr, historySize);
+}
+
+int HistoryIndex::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<int>(m_hashes.size());
+}
+
+/**
+ * Updates memory, then, outside that lock, appends the hash to the index
+ * file and only afterwards moves the header on, so the file never claims
+ * an entry it lacks. Before build() has finished only memory is updated;
+ * build() writes the file with it.
+ */
+void HistoryIndex::record(const std::uint64_t *hash, qint64 historySize)
+{
+    bool added = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        added = hash && m_hashes.insert(*hash).second; // A replayed seed is already known
+        m_covered = std::max(m_covered, historySize);
+        if (!m_built) {
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> fileLock(m_fileMutex);
+    QFile file(m_indexPath);
+    IndexHeader header{};
+    if (!file.open(QIODevice::ReadWrite) ||
+        file.read(reinterpret_cast<char *>(&header), sizeof(header)) != sizeof(header) ||
+        header.magic != INDEX_MAGIC || header.version != INDEX_VERSION) {
+        file.close();
+        writeAll();
+        return;
+    }
+
+    if (added) {
+        file.seek(file.size());
+        file.write(reinterpret_cast<const char *>(hash), sizeof(*hash));
+    }
+    header.historySize = std::max(header.historySize, historySize);
+    file.seek(0);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+}
+
+/**
+ * Hashes the CanonicalForm of the puzzle for its box size
+ */
+bool HistoryIndex::puzzleHash(const Grid &solution, const Grid &givens, std::uint64_t &hash)
+{
+    const int side = static_cast<int>(solution.size());
+    const int box = static_cast<int>(std::lround(std::sqrt(static_cast<double>(side))));
+    if (box < 2 || box > 5 || box * box != side || static_cast<int>(givens.size()) != side) {
+        return false;
+    }
+
+    bool ok = false;
+    dispatchBoxSize(box, [&](auto boxSize) {
+        constexpr int N = decltype(boxSize)::value;
+        using Form = CanonicalForm<N>;
+        typename Form::Cells solutionCells{};
+        typename Form::Cells givenCells{};
+        for (int r = 0; r < side; ++r) {
+            if (static_cast<int>(solution[r].size()) != side || static_cast<int>(givens[r].size()) != side) {
+                return;
+            }
+            for (int c = 0; c < side; ++c) {
+                const int value = solution[r][c];
+                const int given = givens[r][c];
+                if (value < 0 || value > side || given < 0 || given > side) {
+                    return;
+                }
+                solutionCells[r * side + c] = static_cast<std::uint8_t>(value);
+                givenCells[r * side + c] = static_cast<std::uint8_t>(given);
+            }
+        }
+
+        typename Form::Cells form;
+        if (Form::canonicalize(solutionCells, givenCells, form)) {
+            hash = Form::hash(form);
+            ok = true;
+        }
+    });
+    return ok;
+}
+
+/**
+ * The index sits next to the history with an ".idx" suffix
+ */
+QString HistoryIndex::indexPathFor(const QString &historyPath)
+{
+    return historyPath + ".idx";
+}
+
+bool HistoryIndex::load(Hashes &hashes, qint64 &covered) const
+{
+    QFile file(m_indexPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    IndexHeader header{};
+    if (file.read(reinterpret_cast<char *>(&header), sizeof(header)) != sizeof(header) ||
+        header.magic != INDEX_MAGIC || header.version != INDEX_VERSION ||
+        header.historySize != historySize(m_historyPath)) {
+        return false;
+    }
+
+    const QByteArray data = file.readAll();
+    if (data.size() % static_cast<int>(sizeof(std::uint64_t)) != 0) {
+        return false;
+    }
+    const int count = data.size() / static_cast<int>(sizeof(std::uint64_t));
+    hashes.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        std::uint64_t hash;
+        std::memcpy(&hash, data.constData() + i * sizeof(hash), sizeof(hash));
+        hashes.insert(hash);
+    }
+    covered = header.historySize;
+    return true;
+}
+
+/**
+ * Entries without givens, or whose grids do not form a valid puzzle, are
+ * left out. The size is taken before the store is opened, so records
+ * appended meanwhile are at worst hashed without being claimed.
+ */
+bool HistoryIndex::rebuild(const std::atomic<bool> &stop, Hashes &hashes, qint64 &covered) const
+{
+    covered = historySize(m_historyPath);
+    HistoryStore store(m_historyPath);
+    if (stop.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    if (covered == 0 || !store.open()) {
+        return true;
+    }
+    HistoryStore::Entry entry;
+    for (int i = 0; i < store.count(); ++i) {
+        if (stop.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        std::uint64_t hash = 0;
+        if (store.entry(i, entry) && entry.givens.isValid() &&
+            puzzleHash(entry.grid.toGrid(), entry.givens.toGrid(), hash)) {
+            hashes.insert(hash);
+        }
+    }
+    return true;
+}
+
+void HistoryIndex::writeAll()
+{
+    std::vector<std::uint64_t> hashes;
+    IndexHeader header{INDEX_MAGIC, INDEX_VERSION, 0};
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        hashes.assign(m_hashes.begin(), m_hashes.end());
+        header.historySize = m_covered;
+    }
+
+    QSaveFile file(m_indexPath);
+    const qint64 bytes = static_cast<qint64>(hashes.size() * sizeof(std::uint64_t));
+    if (!file.open(QIODevice::WriteOnly) ||
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header)) != sizeof(header) ||
+        file.write(reinterpret_cast<const char *>(hashes.data()), bytes) != bytes || !file.commit()) {
+        qDebug() << "Could not write history index:" << m_indexPath;
+    }
+}
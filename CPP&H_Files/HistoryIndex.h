@@ -0,0 +1,145 @@
+/**
+ * @file HistoryIndex.h
+ * @brief Header file for the HistoryIndex class, a set of played puzzles
+ *
+ * This class is responsible for:
+ * - Keeping the canonical-form hash of every puzzle in the history store
+ * - Answering "has a copy of this puzzle been played?" in O(1)
+ * - Caching the hashes on disk next to the history, and rebuilding that
+ *   cache when the history changed behind its back
+ */
+
+#ifndef HISTORYINDEX_H
+#define HISTORYINDEX_H
+
+#include <QString>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @class HistoryIndex
+ * @brief Hash set of CanonicalForm hashes of played puzzles
+ *
+ * Two puzzles get the same hash when one is a relabelled, permuted,
+ * transposed or rotated copy of the other (see CanonicalForm). Only entries
+ * that record their givens can be indexed; entries written before
+ * savePuzzle stored them are skipped.
+ *
+ * The index file holds a small header (magic, version and the size of the
+ * history store it describes) followed by the raw 64-bit hashes in host
+ * byte order; it is a local cache, not an exchange format. A store whose
+ * size no longer matches is re-read in full. The header only ever claims
+ * entries whose hashes are already in the file, so a crash leaves an index
+ * that is stale rather than one that is trusted but incomplete.
+ *
+ * Nothing is read until build(), which may take a while (a stale cache
+ * means canonicalizing every stored puzzle), so it is meant for a
+ * background thread; until it finishes, contains() answers false.
+ *
+ * All members are thread-safe, so the puzzle pool's thread can query the
+ * index while the history writer adds to it. File writes happen outside
+ * the lock contains() takes.
+ */
+class HistoryIndex
+{
+public:
+    using Grid = std::vector<std::vector<int>>;
+
+    /**
+     * @brief Empty index for a history store; call build() to fill it
+     * @param historyPath HistoryStore file written by SudokuGenerator::savePuzzle
+     */
+    explicit HistoryIndex(const QString &historyPath);
+
+    /**
+     * @brief Loads the cached hashes, or rebuilds them from the store if the
+     * cache is missing or stale; later calls return at once
+     * @param stop Checked between entries while rebuilding
+     * @return False if stop was raised first; the index then stays unbuilt
+     *         and a later call starts over
+     */
+    bool build(const std::atomic<bool> &stop);
+
+    /** @brief Whether build() has finished */
+    bool isBuilt() const;
+
+    HistoryIndex(const HistoryIndex &) = delete;
+    HistoryIndex &operator=(const HistoryIndex &) = delete;
+
+    /**
+     * @brief Whether a puzzle with this hash is in the history
+     * @param hash Value from puzzleHash()
+     */
+    bool contains(std::uint64_t hash) const;
+
+    /**
+     * @brief Records a puzzle that was just appended to the history store
+     * @param hash Value from puzzleHash()
+     * @param historySize Store size up to the end of its record
+     */
+    void insert(std::uint64_t hash, qint64 historySize);
+
+    /**
+     * @brief Records that the store grew by an entry that cannot be indexed,
+     * so the cache keeps matching the store
+     * @param historySize Store size up to the end of its record
+     */
+    void skip(qint64 historySize);
+
+    /** @brief Puzzles indexed */
+    int size() const;
+
+    /**
+     * @brief Canonical-form hash of a puzzle of any supported size
+     * @param solution Complete grid (2x2 to 5x5 boxes)
+     * @param givens The puzzle's clues, 0 for blanks
+     * @param hash Receives the hash
+     * @return False if the grids have the wrong shape, the solution is not
+     *         a valid complete grid, or a given disagrees with it
+     */
+    static bool puzzleHash(const Grid &solution, const Grid &givens, std::uint64_t &hash);
+
+    /**
+     * @brief Location of the index belonging to a history store
+     */
+    static QString indexPathFor(const QString &historyPath);
+
+private:
+    using Hashes = std::unordered_set<std::uint64_t>;
+
+    /** @brief Reads the index file; false if it is missing, damaged or stale */
+    bool load(Hashes &hashes, qint64 &covered) const;
+
+    /**
+     * @brief Hashes every indexable entry of the store
+     * @param covered Receives the store size the hashes describe
+     * @return False if stop was raised first
+     */
+    bool rebuild(const std::atomic<bool> &stop, Hashes &hashes, qint64 &covered) const;
+
+    /**
+     * @brief Adds a hash (if any) to memory and the index file, and moves
+     * the header on to historySize
+     */
+    void record(const std::uint64_t *hash, qint64 historySize);
+
+    /**
+     * @brief Replaces the index file with every hash, in one step, so a
+     * reader never finds it half written (caller holds m_fileMutex)
+     */
+    void writeAll();
+
+    QString m_historyPath;
+    QString m_indexPath;
+    mutable std::mutex m_mutex;     ///< Guards m_hashes, m_covered and m_built
+    std::mutex m_fileMutex;         ///< Serializes writes to the index file
+    std::mutex m_buildMutex;        ///< One build() at a time
+    Hashes m_hashes;
+    qint64 m_covered;               ///< Store size the hashes describe
+    bool m_built;
+};
+
+#endif // HISTORYINDEX_H
@@ -0,0 +1,197 @@
+/**
+ * @file HistoryModel.cpp
+ * @brief Implementation of the HistoryModel class
+ */
+
+#include "HistoryModel.h"
+#include <QFileInfo>
+#include <algorithm>
+
+/**
+ * Constructor for HistoryModel
+ */
+HistoryModel::HistoryModel(QObject *parent)
+    : HistoryModel(HistoryStore::defaultPath(), true, parent)
+{
+}
+
+HistoryModel::HistoryModel(const QString &storePath, QObject *parent)
+    : HistoryModel(storePath, false, parent)
+{
+}
+
+/**
+ * The worker only maps the store and loads its offsets; no entry is decoded
+ * until the view asks for it. The GUI thread does not touch m_store until
+ * opened() has joined the worker.
+ */
+HistoryModel::HistoryModel(const QString &storePath, bool migrate, QObject *parent)
+    : QAbstractListModel(parent),
+      m_store(storePath),
+      m_loaded(0),
+      m_ready(false),
+      m_stopOpening(false)
+{
+    connect(&m_watcher, &QFileSystemWatcher::fileChanged, this, &HistoryModel::refresh);
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &HistoryModel::refresh);
+
+    m_opener = std::thread([this, migrate]() {
+        if (migrate) {
+            HistoryStore::migrateDefaultHistory(&m_stopOpening);
+        }
+        if (!m_stopOpening.load()) {
+            m_store.open();
+        }
+        // Discarded with the model's other posted events if it is destroyed first
+        QMetaObject::invokeMethod(this, [this]() { opened(); }, Qt::QueuedConnection);
+    });
+}
+
+/**
+ * Destructor for HistoryModel
+ */
+HistoryModel::~HistoryModel()
+{
+    m_stopOpening = true;
+    if (m_opener.joinable()) {
+        m_opener.join();
+    }
+}
+
+void HistoryModel::opened()
+{
+    m_opener.join();
+    beginResetModel();
+    m_ready = true;
+    endResetModel();
+    watch();
+}
+
+int HistoryModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_loaded;
+}
+
+QVariant HistoryModel::data(const QModelIndex &index, int role) const
+{
+    const int row = index.row();
+    if (!index.isValid() || row < 0 || row >= m_loaded) {
+        return QVariant();
+    }
+
+    switch (role) {
+    case GridRole:
+        return QVariant::fromValue(grids(row).grid);
+    case GivensRole:
+        return QVariant::fromValue(grids(row).givens);
+    default:
+        break;
+    }
+
+    HistoryStore::Entry entry;
+    if (!m_store.entry(row, entry, false)) {
+        return QVariant();
+    }
+    switch (role) {
+    case DateRole:
+        return entry.date();
+    case TimeRole:
+        return entry.time;
+    case DifficultyRole:
+        return entry.difficulty;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> HistoryModel::roleNames() const
+{
+    return {
+        {DateRole, "date"},
+        {TimeRole, "time"},
+        {DifficultyRole, "difficulty"},
+        {GridRole, "grid"},
+        {GivensRole, "givens"},
+    };
+}
+
+bool HistoryModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && m_ready && m_loaded < m_store.count();
+}
+
+void HistoryModel::fetchMore(const QModelIndex &parent)
+{
+    if (!m_ready) {
+        return;
+    }
+    const int rows = std::min(PAGE_SIZE, m_store.count() - m_loaded);
+    if (parent.isValid() || rows <= 0) {
+        return;
+    }
+    beginInsertRows(QModelIndex(), m_loaded, m_loaded + rows - 1);
+    m_loaded += rows;
+    endInsertRows();
+}
+
+void HistoryModel::refresh()
+{
+    if (!m_ready) {
+        return; // opened() picks up everything written until then
+    }
+    const int added = m_store.refresh();
+    watch(); // A replaced file drops out of the watcher
+    if (added < 0) {
+        beginResetModel();
+        m_recent.clear();
+        m_cached.clear();
+        m_loaded = 0;
+        endResetModel();
+        return;
+    }
+    if (added > 0 && m_loaded == m_store.count() - added) {
+        beginInsertRows(QModelIndex(), m_loaded, m_store.count() - 1);
+        m_loaded = m_store.count();
+        endInsertRows();
+    }
+}
+
+void HistoryModel::watch()
+{
+    const QFileInfo store(m_store.path());
+    if (store.exists() && !m_watcher.files().contains(store.absoluteFilePath())) {
+        m_watcher.addPath(store.absoluteFilePath());
+    }
+
+    // The folder sees the store created, removed or renamed over
+    QString folder = store.absolutePath();
+    while (!QFileInfo(folder).exists() && QFileInfo(folder).absolutePath() != folder) {
+        folder = QFileInfo(folder).absolutePath();
+    }
+    if (QFileInfo(folder).exists() && !m_watcher.directories().contains(folder)) {
+        m_watcher.addPath(folder);
+    }
+}
+
+/**
+ * A hit moves the row to the front; a miss unpacks it there and evicts the
+ * least recently used row once the cache is full
+ */
+const HistoryModel::Grids &HistoryModel::grids(int row) const
+{
+    const auto cached = m_cached.find(row);
+    if (cached != m_cached.end()) {
+        m_recent.splice(m_recent.begin(), m_recent, cached->second);
+        return cached->second->second;
+    }
+
+    HistoryStore::Entry entry;
+    m_store.entry(row, entry);
+    m_recent.emplace_front(row, Grids{entry.grid, entry.givens});
+    m_cached[row] = m_recent.begin();
+    if (static_cast<int>(m_recent.size()) > GRID_CACHE_SIZE) {
+        m_cached.erase(m_recent.back().first);
+        m_recent.pop_back();
+    }
+    return m_recent.front().second;
+}
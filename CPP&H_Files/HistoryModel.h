@@ -0,0 +1,143 @@
+/**
+ * @file HistoryModel.h
+ * @brief Header file for the HistoryModel class, the list behind the History screen
+ *
+ * This class is responsible for:
+ * - Exposing the HistoryStore to a QML ListView one row per finished game
+ * - Handing rows to the view a page at a time as it scrolls
+ * - Decoding an entry only when the view asks for one of its roles
+ * - Following appends to the store as they happen, one row insert per
+ *   new entry
+ * - Opening (and, for the user's history, migrating) the store off the
+ *   GUI thread
+ */
+
+#ifndef HISTORYMODEL_H
+#define HISTORYMODEL_H
+
+#include <QAbstractListModel>
+#include <QFileSystemWatcher>
+#include <QString>
+#include <atomic>
+#include <list>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include "Board.h"
+#include "HistoryStore.h"
+
+/**
+ * @class HistoryModel
+ * @brief Paged, lazily decoded list model of the puzzle history
+ *
+ * Rows are the store's entries in the order they were saved. The view
+ * starts with no rows and pulls PAGE_SIZE more through fetchMore whenever
+ * it scrolls near the end, so opening the screen costs the same for ten
+ * entries as for a million.
+ *
+ * Date, time and difficulty are read straight from the store's mapping on
+ * every data() call. Grids are unpacked into a Board on first request and
+ * the most recent GRID_CACHE_SIZE rows are kept, so scrolling back over
+ * visible rows does not unpack them again.
+ *
+ * The store is opened on a worker thread, since migrating a legacy text
+ * history or scanning a store without an offset index can take a while;
+ * the model has no rows until then and resets itself when the store is
+ * ready.
+ *
+ * A file watcher on the store (and on its folder, which sees the store
+ * being created or replaced) triggers refresh(). Only the bytes appended
+ * since the last look are validated, and the new entries are inserted as
+ * rows if the view already had every row; otherwise they just become
+ * fetchable. A store that was truncated or replaced resets the model.
+ */
+class HistoryModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    /** @brief Data roles of an entry */
+    enum Roles {
+        DateRole = Qt::UserRole + 1, ///< "date": "yyyy-MM-dd hh:mm:ss", empty if unknown
+        TimeRole,                    ///< "time": seconds taken
+        DifficultyRole,              ///< "difficulty": 1 to 3
+        GridRole,                    ///< "grid": completed Board
+        GivensRole                   ///< "givens": Board of clues, invalid if not recorded
+    };
+    Q_ENUM(Roles)
+
+    /** @brief Rows added by one fetchMore */
+    static constexpr int PAGE_SIZE = 50;
+
+    /** @brief Decoded rows kept */
+    static constexpr int GRID_CACHE_SIZE = 64;
+
+    /**
+     * @brief Model of the user's history, migrated from the text history if needed
+     * @param parent Parent QObject (default: nullptr)
+     */
+    explicit HistoryModel(QObject *parent = nullptr);
+
+    /**
+     * @brief Model of the store at a path
+     * @param storePath HistoryStore file; a missing file gives an empty model
+     * @param parent Parent QObject (default: nullptr)
+     */
+    explicit HistoryModel(const QString &storePath, QObject *parent = nullptr);
+
+    /**
+     * @brief Abandons a migration still in progress and waits for the worker
+     */
+    ~HistoryModel() override;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    /** @brief Whether the store has entries the view has not been given yet */
+    bool canFetchMore(const QModelIndex &parent) const override;
+
+    /** @brief Adds up to PAGE_SIZE rows */
+    void fetchMore(const QModelIndex &parent) override;
+
+    /** @brief Picks up entries appended to the store since the last look */
+    Q_INVOKABLE void refresh();
+
+private:
+    /**
+     * @brief Starts the worker that migrates (if asked to) and opens the store
+     */
+    HistoryModel(const QString &storePath, bool migrate, QObject *parent);
+
+    /** @brief Runs on the GUI thread once the worker has opened the store */
+    void opened();
+
+    /**
+     * @brief Watches the store, or the closest existing folder above it
+     * until the store is created
+     */
+    void watch();
+
+    /** @brief Decoded grids of one row */
+    struct Grids {
+        Board grid;
+        Board givens;
+    };
+
+    /** @brief Grids of a row, from the cache or freshly unpacked */
+    const Grids &grids(int row) const;
+
+    HistoryStore m_store;
+    QFileSystemWatcher m_watcher;
+    int m_loaded; ///< Rows handed to the view so far
+    bool m_ready; ///< Set once the worker has opened m_store; GUI thread only
+
+    std::atomic<bool> m_stopOpening; ///< Set to abandon a migration
+    std::thread m_opener;            ///< Owns m_store until opened() runs
+
+    /** @brief Recently decoded rows, most recent first */
+    mutable std::list<std::pair<int, Grids>> m_recent;
+    mutable std::unordered_map<int, std::list<std::pair<int, Grids>>::iterator> m_cached;
+};
+
+#endif // HISTORYMODEL_H
@@ -4,136 +4,88 @@
  */
 
 #include "HistoryRead.h"
+#include "HistoryStore.h"
+#include "LegacyHistoryParser.h"
 #include <QFile>
-#include <QTextStream>
 #include <QStandardPaths>
-#include <QDir>
 #include <QDebug>
-#include <string>
-#include <vector>
-#include <fstream>
 
 /**
  * Constructor for HistoryRead
  */
-HistoryRead::HistoryRead(QObject *parent) : QObject(parent)
+HistoryRead::HistoryRead(QObject *parent)
+    : QObject(parent),
+      m_store(HistoryStore::defaultPath())
 {
-    // Constructor (no initialization needed)
+    // The store is opened by the first getHistory
 }
 
 /**
- * Retrieves the puzzle history from the history file
+ * Retrieves the puzzle history from the history store
  * 
- * @return QVariantList containing all puzzle entries
+ * @return QVariantList containing all puzzle entries, in the same shape
+ *         readHistoryFile produces
  */
 QVariantList HistoryRead::getHistory()
 {
-    // Container for history entries
-    QVariantList historyList;
-    
-    // Get the path to the history file
-    QString path = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
-    QString filePath = path + "/SudokuPuzzles/solved_puzzles_history.txt";
-    QFile file(filePath);
-
-    // Check if the file exists
-    if (!file.exists()) {
-        qDebug() << "History file does not exist:" << filePath;
-        return historyList;
+    HistoryStore::migrateDefaultHistory();
+    if (m_store.refresh() < 0) {
+        m_history.clear(); // Truncated or replaced: start over
     }
 
-    // Read the file
-    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        // Read all lines into memory
-        QTextStream in(&file);
-        QStringList lines;
-        while (!in.atEnd()) {
-            lines << in.readLine();
+    HistoryStore::Entry stored;
+    for (int i = static_cast<int>(m_history.size()); i < m_store.count(); ++i) {
+        if (!m_store.entry(i, stored)) {
+            break;
         }
-        file.close();
-
-        // Parse each puzzle entry
-        int i = 0;
-        while (i < lines.size()) {
-            if (lines[i].trimmed() == "--- Puzzle Entry ---") {
-                historyList.append(parsePuzzleEntry(lines, i));
-            } else {
-                i++; // Skip lines that are not puzzle entries
-            }
+        QVariantMap entry;
+        entry["date"] = stored.date();
+        entry["time"] = stored.time;
+        entry["difficulty"] = stored.difficulty;
+        entry["grid"] = stored.grid.toVariantList();
+        if (stored.givens.isValid()) {
+            entry["givens"] = stored.givens.toVariantList();
         }
-    } else {
-        qDebug() << "Could not open history file:" << filePath;
+        m_history.append(entry);
     }
-    
-    return historyList;
+    return m_history;
 }
 
 /**
- * Parses a single puzzle entry from the history file
+ * Path of the legacy text history under the user's documents directory
  * 
- * @param lines All lines from the history file
- * @param startIndex Index of the current line (updated during parsing)
- * @return QVariantMap containing the parsed puzzle entry
+ * @return Absolute file path
  */
-QVariantMap HistoryRead::parsePuzzleEntry(const QStringList &lines, int &startIndex)
+QString HistoryRead::historyFilePath()
 {
-    // Create a map to store puzzle entry data
-    QVariantMap entry;
-    int time = 0;
-    QString date;
-    int difficulty = 0;
-    QVariantList grid;
-
-    // Skip the entry header line
-    startIndex++;
-
-    // Parse date
-    if (startIndex < lines.size() && lines[startIndex].startsWith("Date: ")) {
-        QString prefix = "Date: ";
-        date = lines[startIndex].mid(lines[startIndex].indexOf(prefix) + prefix.length()).trimmed();
-        startIndex++;
-    }
-
-    // Parse completion time
-    if (startIndex < lines.size() && lines[startIndex].startsWith("Completion Time (seconds): ")) {
-        QString prefix = "Completion Time (seconds): ";
-        time = lines[startIndex].mid(lines[startIndex].indexOf(prefix) + prefix.length()).trimmed().toInt();
-        startIndex++;
-    }
+    QString path = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
+    return path + "/SudokuPuzzles/solved_puzzles_history.txt";
+}
 
-    // Parse difficulty
-    if (startIndex < lines.size() && lines[startIndex].startsWith("Difficulty: ")) {
-        QString prefix = "Difficulty: ";
-        difficulty = lines[startIndex].mid(lines[startIndex].indexOf(prefix) + prefix.length()).trimmed().toInt();
-        startIndex++;
-    }
+/**
+ * Reads and parses every entry of a legacy text history
+ * 
+ * @param filePath Path of the history file
+ * @return QVariantList containing all puzzle entries
+ */
+QVariantList HistoryRead::readHistoryFile(const QString &filePath)
+{
+    // Container for history entries
+    QVariantList historyList;
 
-    // Skip the "Puzzle:" line
-    if (startIndex < lines.size() && lines[startIndex].trimmed() == "Puzzle:") {
-        startIndex++;
+    // Check if the file exists
+    if (!QFile::exists(filePath)) {
+        qDebug() << "History file does not exist:" << filePath;
+        return historyList;
     }
 
-    // Parse the puzzle grid
-    for (int row = 0; row < 9; ++row) {
-        if (startIndex < lines.size()) {
-            QVariantList qmlRow;
-            QStringList cells = lines[startIndex].trimmed().split(" ", Qt::SkipEmptyParts);
-            for (const QString &cell : cells) {
-                qmlRow.append(cell.toInt());
-            }
-            grid.append(qmlRow);
-            startIndex++;
-        } else {
-            // Incomplete puzzle entry, break
-            break;
-        }
+    // Stream the file; only the returned maps are allocated per entry
+    const bool read = LegacyHistoryParser::parseFile(filePath, [&historyList](const LegacyHistoryParser::Entry &entry) {
+        historyList.append(entry.toVariantMap());
+    });
+    if (!read) {
+        qDebug() << "Could not open history file:" << filePath;
     }
-
-    // Store parsed data in the map
-    entry["date"] = date;
-    entry["time"] = time;
-    entry["difficulty"] = difficulty;
-    entry["grid"] = grid;
     
-    return entry;
-}
\ No newline at end of file
+    return historyList;
+}
@@ -3,8 +3,8 @@
  * @brief Header file for the HistoryRead class which reads puzzle history
  * 
  * This class is responsible for:
- * - Reading saved puzzle history from a file
- * - Parsing puzzle entries into a format usable by QML
+ * - Reading saved puzzle history from the HistoryStore
+ * - Converting entries of the legacy text history into a format usable by QML
  * - Providing access to historical puzzle data
  */
 
@@ -15,6 +15,7 @@
 #include <QVariantList>
 #include <QVariantMap>
 #include <QString>
+#include "HistoryStore.h"
 
 /**
  * @class HistoryRead
@@ -34,19 +35,30 @@ public:
     explicit HistoryRead(QObject *parent = nullptr);
 
     /**
-     * @brief Retrieves the puzzle history
-     * @return QVariantList containing all puzzle entries
+     * @brief Retrieves the puzzle history, migrating a legacy text history first
+     * @return QVariantList containing all puzzle entries, oldest first
+     *
+     * The entries are kept between calls; later calls only decode what was
+     * appended to the store since, unless it was truncated or replaced.
      */
     Q_INVOKABLE QVariantList getHistory();
 
-private:
     /**
-     * @brief Parses a single puzzle entry from the history file
-     * @param lines All lines from the history file
-     * @param startIndex Index of the current line (updated during parsing)
-     * @return QVariantMap containing the parsed puzzle entry
+     * @brief Reads and parses a legacy text history at an arbitrary path
+     * @param filePath History file in the format SudokuGenerator::savePuzzle
+     *        wrote before the HistoryStore
+     * @return QVariantList containing all puzzle entries (empty if unreadable)
+     */
+    QVariantList readHistoryFile(const QString &filePath);
+
+    /**
+     * @brief Location of the user's legacy text history
      */
-    QVariantMap parsePuzzleEntry(const QStringList &lines, int &startIndex);
+    static QString historyFilePath();
+
+private:
+    HistoryStore m_store;
+    QVariantList m_history; ///< Entries decoded so far, one per store entry
 };
 
 #endif // HISTORYREAD_H
\ No newline at end of file
@@ -0,0 +1,649 @@
+/**
+ * @file HistoryStore.cpp
+ * @brief Implementation of the HistoryStore class
+ */
+
+#include "HistoryStore.h"
+#include "HistoryRead.h"
+#include "LegacyHistoryParser.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <cstring>
+#include <mutex>
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+/** @brief Start of every store file ("SXHS") */
+constexpr quint32 STORE_MAGIC = 0x53485853u;
+
+/** @brief Bumped whenever the record layout changes */
+constexpr quint32 STORE_VERSION = 1;
+
+/** @brief Bytes before the first record */
+constexpr qint64 STORE_HEADER_SIZE = 16;
+
+/** @brief Fixed part of every record */
+constexpr int RECORD_HEADER_SIZE = 24;
+
+/** @brief Record flag: the givens follow the grid */
+constexpr quint8 FLAG_GIVENS = 1;
+
+/** @brief Start of every offset index ("SXHO") */
+constexpr quint32 OFFSETS_MAGIC = 0x4f485853u;
+
+/** @brief Bumped whenever the offset index layout changes */
+constexpr quint32 OFFSETS_VERSION = 1;
+
+/** @brief Fixed part at the start of the offset index */
+struct OffsetsHeader {
+    quint32 magic;
+    quint32 version;
+    qint64 storeSize;   ///< Bytes of store the offsets describe
+};
+
+/** @brief Bits per packed cell: digits up to 9 fit a nibble, up to 25 need five bits */
+int bitsPerCell(int boxSize)
+{
+    return boxSize <= 3 ? 4 : 5;
+}
+
+/** @brief Bytes of one packed grid */
+int packedSize(int boxSize)
+{
+    const int cells = boxSize * boxSize * boxSize * boxSize;
+    return (cells * bitsPerCell(boxSize) + 7) / 8;
+}
+
+/** @brief Bytes of a whole record */
+int recordSize(int boxSize, bool givens)
+{
+    return RECORD_HEADER_SIZE + packedSize(boxSize) * (givens ? 2 : 1);
+}
+
+/** @brief Packs a board's cells, lowest bits first */
+void pack(const Board &board, uchar *out)
+{
+    const int bits = bitsPerCell(board.boxSize());
+    const std::uint8_t *cells = board.cells();
+    quint32 buffer = 0;
+    int buffered = 0;
+    for (int cell = 0; cell < board.cellCount(); ++cell) {
+        buffer |= quint32(cells[cell]) << buffered;
+        buffered += bits;
+        while (buffered >= 8) {
+            *out++ = static_cast<uchar>(buffer);
+            buffer >>= 8;
+            buffered -= 8;
+        }
+    }
+    if (buffered > 0) {
+        *out = static_cast<uchar>(buffer);
+    }
+}
+
+/**
+ * @brief Unpacks a grid written by pack()
+ * @return False if a cell holds more than the grid's size
+ */
+bool unpack(const uchar *in, int boxSize, Board &board)
+{
+    board = Board(boxSize);
+    const int bits = bitsPerCell(boxSize);
+    const quint32 mask = (1u << bits) - 1;
+    const int size = board.size();
+    std::uint8_t *cells = board.cells();
+    quint32 buffer = 0;
+    int buffered = 0;
+    for (int cell = 0; cell < board.cellCount(); ++cell) {
+        while (buffered < bits) {
+            buffer |= quint32(*in++) << buffered;
+            buffered += 8;
+        }
+        const quint32 value = buffer & mask;
+        buffer >>= bits;
+        buffered -= bits;
+        if (value > static_cast<quint32>(size)) {
+            return false;
+        }
+        cells[cell] = static_cast<std::uint8_t>(value);
+    }
+    return true;
+}
+
+/** @brief 32-bit FNV-1a */
+quint32 checksum(const uchar *data, qint64 size)
+{
+    quint32 hash = 2166136261u;
+    for (qint64 i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Size of the record at data, or 0 if it is cut short or damaged
+ * @param available Bytes from data to the end of the file
+ */
+int validRecord(const uchar *data, qint64 available)
+{
+    if (available < RECORD_HEADER_SIZE) {
+        return 0;
+    }
+    const int size = qFromLittleEndian<quint16>(data + 4);
+    const int boxSize = data[6];
+    const quint8 flags = data[7];
+    if (boxSize < 2 || boxSize > 5 || (flags & ~FLAG_GIVENS) != 0 ||
+        size != recordSize(boxSize, flags & FLAG_GIVENS) || size > available) {
+        return 0;
+    }
+    return qFromLittleEndian<quint32>(data) == checksum(data + 4, size - 4) ? size : 0;
+}
+
+/** @brief Serializes an entry; empty if it is malformed */
+QByteArray encodeRecord(const HistoryStore::Entry &entry)
+{
+    const int boxSize = entry.grid.boxSize();
+    const bool givens = entry.givens.isValid();
+    if (!entry.grid.isValid() || (givens && entry.givens.boxSize() != boxSize)) {
+        return QByteArray();
+    }
+
+    const int size = recordSize(boxSize, givens);
+    QByteArray record(size, '\0');
+    uchar *data = reinterpret_cast<uchar *>(record.data());
+    qToLittleEndian<quint16>(static_cast<quint16>(size), data + 4);
+    data[6] = static_cast<uchar>(boxSize);
+    data[7] = givens ? FLAG_GIVENS : 0;
+    qToLittleEndian<qint64>(entry.timestamp, data + 8);
+    qToLittleEndian<qint32>(entry.time, data + 16);
+    qToLittleEndian<qint32>(entry.difficulty, data + 20);
+    pack(entry.grid, data + RECORD_HEADER_SIZE);
+    if (givens) {
+        pack(entry.givens, data + RECORD_HEADER_SIZE + packedSize(boxSize));
+    }
+    qToLittleEndian<quint32>(checksum(data + 4, size - 4), data);
+    return record;
+}
+
+/**
+ * @brief Replaces an offset index in one step, so a reader never sees it
+ * half written
+ */
+bool saveOffsets(const QString &path, const std::vector<qint64> &offsets, qint64 storeSize)
+{
+    QSaveFile file(path);
+    const OffsetsHeader header{OFFSETS_MAGIC, OFFSETS_VERSION, storeSize};
+    const qint64 bytes = static_cast<qint64>(offsets.size() * sizeof(qint64));
+    if (!file.open(QIODevice::WriteOnly) ||
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header)) != sizeof(header) ||
+        file.write(reinterpret_cast<const char *>(offsets.data()), bytes) != bytes || !file.commit()) {
+        qDebug() << "Could not write history offsets:" << path;
+        return false;
+    }
+    return true;
+}
+
+/** @brief The store header */
+QByteArray storeHeader()
+{
+    QByteArray header(STORE_HEADER_SIZE, '\0');
+    qToLittleEndian<quint32>(STORE_MAGIC, header.data());
+    qToLittleEndian<quint32>(STORE_VERSION, header.data() + 4);
+    return header;
+}
+
+} // namespace
+
+QString HistoryStore::Entry::date() const
+{
+    return timestamp != 0 ? QDateTime::fromSecsSinceEpoch(timestamp).toString("yyyy-MM-dd hh:mm:ss") : QString();
+}
+
+/**
+ * Constructor for HistoryStore
+ */
+HistoryStore::HistoryStore(const QString &path)
+    : m_path(path),
+      m_file(path),
+      m_map(nullptr),
+      m_mappedSize(0),
+      m_end(0)
+{
+}
+
+HistoryStore::~HistoryStore()
+{
+    unmap();
+}
+
+/**
+ * Loads the offset index when it still describes the file, then validates
+ * only what was appended after it. Nothing is written: a damaged tail is
+ * reported and left for the next append to replace, and a stale index for
+ * the next append to rewrite.
+ */
+bool HistoryStore::open()
+{
+    unmap();
+    m_file.close();
+    m_offsets.clear();
+    m_end = 0;
+    if (!m_file.exists()) {
+        return true; // Nothing played yet
+    }
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        qDebug() << "Could not open history store:" << m_path;
+        return false;
+    }
+
+    const qint64 size = m_file.size();
+    if (size < STORE_HEADER_SIZE || !ensureMapped(STORE_HEADER_SIZE) ||
+        qFromLittleEndian<quint32>(m_map) != STORE_MAGIC ||
+        qFromLittleEndian<quint32>(m_map + 4) != STORE_VERSION) {
+        qDebug() << "Not a history store:" << m_path;
+        unmap();
+        m_file.close();
+        return false;
+    }
+
+    m_end = scan(loadOffsets() ? m_end : STORE_HEADER_SIZE);
+    if (m_end < size) {
+        qDebug() << "History store ends in" << size - m_end << "bytes of an incomplete record";
+    }
+    return true;
+}
+
+int HistoryStore::count() const
+{
+    return static_cast<int>(m_offsets.size());
+}
+
+qint64 HistoryStore::endOf(int index) const
+{
+    const std::size_t next = static_cast<std::size_t>(index) + 1;
+    return next < m_offsets.size() ? m_offsets[next] : m_end;
+}
+
+/**
+ * Reads straight from the mapping. Offsets loaded from the sidecar were
+ * only checked for order, so the record is validated again here; one
+ * checksum over about a hundred bytes costs little next to unpacking.
+ */
+bool HistoryStore::entry(int index, Entry &entry, bool withGrids) const
+{
+    if (index < 0 || index >= count()) {
+        return false;
+    }
+    const qint64 offset = m_offsets[index];
+    const qint64 recordEnd = index + 1 < count() ? m_offsets[index + 1] : m_end;
+    if (offset < STORE_HEADER_SIZE || recordEnd <= offset || recordEnd > m_end ||
+        !ensureMapped(recordEnd) || validRecord(m_map + offset, recordEnd - offset) != recordEnd - offset) {
+        return false;
+    }
+
+    const uchar *record = m_map + offset;
+    const int boxSize = record[6];
+    entry.timestamp = qFromLittleEndian<qint64>(record + 8);
+    entry.time = qFromLittleEndian<qint32>(record + 16);
+    entry.difficulty = qFromLittleEndian<qint32>(record + 20);
+    entry.grid = Board();
+    entry.givens = Board();
+    if (!withGrids) {
+        return true;
+    }
+    if (!unpack(record + RECORD_HEADER_SIZE, boxSize, entry.grid)) {
+        return false;
+    }
+    if ((record[7] & FLAG_GIVENS) &&
+        !unpack(record + RECORD_HEADER_SIZE + packedSize(boxSize), boxSize, entry.givens)) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Writes at the end of the last valid record, so a torn record left by an
+ * interrupted append is cut off and replaced
+ */
+bool HistoryStore::append(const Entry &entry)
+{
+    return append(std::vector<Entry>{entry});
+}
+
+/**
+ * Encodes the whole batch first, so it goes out in one write
+ */
+bool HistoryStore::append(const std::vector<Entry> &entries)
+{
+    QByteArray records;
+    std::vector<qint64> sizes;
+    sizes.reserve(entries.size());
+    for (const Entry &entry : entries) {
+        const QByteArray record = encodeRecord(entry);
+        if (record.isEmpty()) {
+            qDebug() << "Not storing a malformed history entry";
+            return false;
+        }
+        records.append(record);
+        sizes.push_back(record.size());
+    }
+    if (sizes.empty()) {
+        return true;
+    }
+
+    if (!m_file.isOpen()) {
+        // First entry ever: create the folder and the header
+        if (!m_file.exists()) {
+            QDir().mkpath(QFileInfo(m_path).absolutePath());
+            QFile file(m_path);
+            if (!file.open(QIODevice::WriteOnly) || file.write(storeHeader()) != STORE_HEADER_SIZE) {
+                qDebug() << "Could not create history store:" << m_path;
+                return false;
+            }
+        }
+        if (!open() || !m_file.isOpen()) {
+            return false;
+        }
+    } else {
+        refresh();
+    }
+
+    if (m_file.size() > m_end) {
+        qDebug() << "Dropping an incomplete history record at" << m_end;
+        unmap();
+        m_file.resize(m_end);
+    }
+    if (!m_file.seek(m_end) || m_file.write(records) != records.size() || !m_file.flush()) {
+        qDebug() << "Could not append to history store:" << m_file.errorString();
+        return false;
+    }
+
+    const std::size_t first = m_offsets.size();
+    for (qint64 size : sizes) {
+        m_offsets.push_back(m_end);
+        m_end += size;
+    }
+    appendOffsets(first);
+    return true;
+}
+
+/**
+ * QFile::flush only hands the data to the operating system; this waits
+ * until it is on the disk
+ */
+bool HistoryStore::sync()
+{
+    if (!m_file.isOpen()) {
+        return true;
+    }
+    if (!m_file.flush()) {
+        return false;
+    }
+#ifdef Q_OS_WIN
+    return _commit(m_file.handle()) == 0;
+#else
+    return ::fsync(m_file.handle()) == 0;
+#endif
+}
+
+int HistoryStore::refresh()
+{
+    if (!m_file.isOpen()) {
+        const int before = count();
+        open();
+        return count() - before;
+    }
+
+    // A file replaced under the same name no longer matches the open handle;
+    // one truncated and rewritten no longer has the last known record
+    const qint64 size = m_file.size();
+    if (size < m_end || QFileInfo(m_path).size() != size || !tailIntact()) {
+        open();
+        return -1;
+    }
+    // The offsets found stay in memory: whoever appended has already
+    // recorded them in the sidecar
+    const std::size_t known = m_offsets.size();
+    if (size > m_end) {
+        m_end = scan(m_end);
+    }
+    return static_cast<int>(m_offsets.size() - known);
+}
+
+QString HistoryStore::path() const
+{
+    return m_path;
+}
+
+/**
+ * Path of the store under the user's documents directory, next to the
+ * legacy text history
+ */
+QString HistoryStore::defaultPath()
+{
+    QString path = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
+    return path + "/SudokuPuzzles/solved_puzzles_history.bin";
+}
+
+/**
+ * The offsets sit next to the store with an ".off" suffix
+ */
+QString HistoryStore::offsetsPathFor(const QString &storePath)
+{
+    return storePath + ".off";
+}
+
+/**
+ * Streams the text through LegacyHistoryParser. Entries whose grid is not a
+ * supported square cannot be stored and are skipped.
+ */
+int HistoryStore::migrateLegacy(const QString &textPath, const QString &storePath,
+                                const std::atomic<bool> *stop)
+{
+    if (!QFile::exists(textPath)) {
+        qDebug() << "Legacy history does not exist:" << textPath;
+        return -1;
+    }
+    QDir().mkpath(QFileInfo(storePath).absolutePath());
+    QSaveFile store(storePath);
+    if (!store.open(QIODevice::WriteOnly) || store.write(storeHeader()) != STORE_HEADER_SIZE) {
+        qDebug() << "Could not create history store:" << storePath;
+        return -1;
+    }
+
+    std::vector<qint64> offsets;
+    qint64 end = STORE_HEADER_SIZE;
+    int migrated = 0;
+    int skipped = 0;
+    const bool read = LegacyHistoryParser::parseFile(textPath, [&](const LegacyHistoryParser::Entry &parsed) {
+        Entry entry;
+        const QDateTime date = QDateTime::fromString(QString::fromUtf8(parsed.date().data(), parsed.date().size()),
+                                                     "yyyy-MM-dd hh:mm:ss");
+        entry.timestamp = date.isValid() ? date.toSecsSinceEpoch() : 0;
+        entry.time = parsed.time();
+        entry.difficulty = parsed.difficulty();
+        entry.grid = parsed.grid();
+        entry.givens = parsed.givens();
+        const QByteArray record = encodeRecord(entry);
+        if (record.isEmpty()) {
+            ++skipped;
+        } else if (store.write(record) == record.size()) {
+            offsets.push_back(end);
+            end += record.size();
+            ++migrated;
+        }
+    }, stop);
+    if (!read) {
+        if (!stop || !stop->load()) {
+            qDebug() << "Could not read legacy history:" << textPath;
+        }
+        store.cancelWriting();
+        return -1;
+    }
+
+    if (!store.commit()) {
+        qDebug() << "Could not write history store:" << storePath;
+        return -1;
+    }
+    saveOffsets(offsetsPathFor(storePath), offsets, end); // Spares every reader a first scan
+    if (skipped > 0) {
+        qDebug() << "Skipped" << skipped << "malformed legacy history entries";
+    }
+    return migrated;
+}
+
+QString HistoryStore::migrateDefaultHistory(const std::atomic<bool> *stop)
+{
+    static std::mutex migrating;
+    std::lock_guard<std::mutex> lock(migrating);
+    const QString storePath = defaultPath();
+    const QString textPath = HistoryRead::historyFilePath();
+    if (!QFile::exists(storePath) && QFile::exists(textPath)) {
+        const int migrated = migrateLegacy(textPath, storePath, stop);
+        if (migrated >= 0) {
+            qDebug() << "Migrated" << migrated << "history entries to" << storePath;
+        }
+    }
+    return storePath;
+}
+
+qint64 HistoryStore::scan(qint64 from)
+{
+    const qint64 size = m_file.size();
+    if (!ensureMapped(size)) {
+        return from;
+    }
+    qint64 offset = from;
+    while (offset < size) {
+        const int recordBytes = validRecord(m_map + offset, size - offset);
+        if (recordBytes == 0) {
+            break;
+        }
+        m_offsets.push_back(offset);
+        offset += recordBytes;
+    }
+    return offset;
+}
+
+bool HistoryStore::ensureMapped(qint64 size) const
+{
+    if (m_map && m_mappedSize >= size) {
+        return true;
+    }
+    unmap();
+    const qint64 fileSize = m_file.size();
+    if (fileSize < size || fileSize == 0) {
+        return false;
+    }
+    m_map = m_file.map(0, fileSize);
+    m_mappedSize = m_map ? fileSize : 0;
+    return m_map != nullptr;
+}
+
+void HistoryStore::unmap() const
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+        m_mappedSize = 0;
+    }
+}
+
+/**
+ * Trusts the index only if it covers no more than the file, its offsets
+ * strictly increase within the store, and its last offset is a valid
+ * record ending exactly where the index says. Offsets at or past the
+ * covered size belong to an append whose header update is still to come;
+ * they are dropped and the records found again by the scan.
+ */
+bool HistoryStore::loadOffsets()
+{
+    QFile file(offsetsPathFor(m_path));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    OffsetsHeader header{};
+    if (file.read(reinterpret_cast<char *>(&header), sizeof(header)) != sizeof(header) ||
+        header.magic != OFFSETS_MAGIC || header.version != OFFSETS_VERSION ||
+        header.storeSize < STORE_HEADER_SIZE || header.storeSize > m_file.size()) {
+        return false;
+    }
+
+    const qint64 bytes = file.size() - static_cast<qint64>(sizeof(header));
+    if (bytes < 0 || bytes % static_cast<qint64>(sizeof(qint64)) != 0) {
+        return false;
+    }
+    m_offsets.resize(static_cast<std::size_t>(bytes / sizeof(qint64)));
+    if (bytes > 0 && file.read(reinterpret_cast<char *>(m_offsets.data()), bytes) != bytes) {
+        m_offsets.clear();
+        return false;
+    }
+
+    m_end = header.storeSize;
+    while (!m_offsets.empty() && m_offsets.back() >= m_end) {
+        m_offsets.pop_back();
+    }
+    qint64 previous = STORE_HEADER_SIZE - 1;
+    for (qint64 offset : m_offsets) {
+        if (offset <= previous || offset >= m_end) {
+            m_offsets.clear();
+            return false;
+        }
+        previous = offset;
+    }
+    if (!tailIntact()) {
+        m_offsets.clear();
+        return false;
+    }
+    return true;
+}
+
+bool HistoryStore::tailIntact() const
+{
+    if (m_offsets.empty()) {
+        return m_end == STORE_HEADER_SIZE;
+    }
+    const qint64 last = m_offsets.back();
+    return m_offsets.front() == STORE_HEADER_SIZE && last < m_end && ensureMapped(m_end) &&
+           last + validRecord(m_map + last, m_end - last) == m_end;
+}
+
+/**
+ * Appends the new offsets, then records the covered size in the header so
+ * the next open trusts them. Readers loading the index in between see the
+ * old header and drop the extra offsets. The appending instance is the only
+ * writer, so the index can only be stale from before it opened the store;
+ * it is then replaced whole.
+ */
+void HistoryStore::appendOffsets(std::size_t first) const
+{
+    QFile file(offsetsPathFor(m_path));
+    OffsetsHeader header{};
+    if (!file.open(QIODevice::ReadWrite) ||
+        file.read(reinterpret_cast<char *>(&header), sizeof(header)) != sizeof(header) ||
+        header.magic != OFFSETS_MAGIC || header.version != OFFSETS_VERSION ||
+        header.storeSize != m_offsets[first] ||
+        file.size() != static_cast<qint64>(sizeof(header) + first * sizeof(qint64))) {
+        file.close();
+        saveOffsets(file.fileName(), m_offsets, m_end);
+        return;
+    }
+
+    file.seek(file.size());
+    file.write(reinterpret_cast<const char *>(m_offsets.data() + first),
+               static_cast<qint64>((m_offsets.size() - first) * sizeof(qint64)));
+    header.storeSize = m_end;
+    file.seek(0);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+}
@@ -0,0 +1,214 @@
+/**
+ * @file HistoryStore.h
+ * @brief Header file for the HistoryStore class, the binary puzzle history
+ *
+ * This class is responsible for:
+ * - Appending finished games as compact binary records
+ * - Reading any entry in O(1) through a memory map and an offset index
+ * - Detecting and dropping a record that was only partly written
+ * - Migrating the legacy text history into the binary format once
+ */
+
+#ifndef HISTORYSTORE_H
+#define HISTORYSTORE_H
+
+#include <QFile>
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+#include <vector>
+#include "Board.h"
+
+/**
+ * @class HistoryStore
+ * @brief Append-only file of history records with an offset index
+ *
+ * The store starts with a 16-byte header (magic, version, reserved). Each
+ * record after it holds, in little-endian order:
+ *
+ * | Bytes | Field                                                    |
+ * |-------|----------------------------------------------------------|
+ * | 4     | FNV-1a checksum of the rest of the record                |
+ * | 2     | Record size in bytes, this header included               |
+ * | 1     | Box size (2 to 5)                                        |
+ * | 1     | Flags; bit 0 set when the givens follow the grid         |
+ * | 8     | Completion timestamp, seconds since the epoch            |
+ * | 4     | Seconds taken                                            |
+ * | 4     | Difficulty                                               |
+ * | n     | Completed grid, 4 bits per cell up to 9x9, 5 bits above  |
+ * | n     | Givens, same packing (only with flag bit 0)              |
+ *
+ * A 9x9 entry with its givens is 106 bytes, against roughly 420 in the text
+ * format. Records differ in size with the box size and the givens flag, so
+ * their start offsets are kept in a sidecar file (offsetsPathFor) that
+ * records how much of the store it covers. Opening reads that array and
+ * scans only the records appended after it; a missing or inconsistent
+ * index is rebuilt by one scan of the store. Only append() writes the
+ * index, so an instance that only reads never touches it.
+ *
+ * A record whose size or checksum does not check out ends the scan. It is
+ * what is left of an interrupted append, so it is cut off the file and the
+ * next append takes its place.
+ *
+ * Not thread-safe: one thread at a time per instance. Several instances
+ * may have the same file open in one process, but only one of them may
+ * append; the others pick up its appends when they call refresh(). The
+ * game's saves go through HistoryWriter, whose instance is that appender.
+ */
+class HistoryStore
+{
+public:
+    /** @brief One finished game */
+    struct Entry {
+        qint64 timestamp = 0; ///< When it was finished, seconds since the epoch (0 if unknown)
+        int time = 0;         ///< Seconds taken
+        int difficulty = 0;   ///< Difficulty level
+        Board grid;           ///< Completed grid
+        Board givens;         ///< Clues it started from; invalid if not recorded
+
+        /** @brief The timestamp as "yyyy-MM-dd hh:mm:ss" local time, empty if unknown */
+        QString date() const;
+    };
+
+    /**
+     * @brief Store at a path; nothing is read until open()
+     * @param path Store file, created by the first append
+     */
+    explicit HistoryStore(const QString &path);
+    ~HistoryStore();
+
+    HistoryStore(const HistoryStore &) = delete;
+    HistoryStore &operator=(const HistoryStore &) = delete;
+
+    /**
+     * @brief Maps the store and loads its offset index, scanning whatever
+     * the index does not cover; the scanned offsets are kept in memory
+     * @return False if the file exists but is not a history store or
+     *         cannot be read; a missing file opens as an empty store
+     */
+    bool open();
+
+    /** @brief Entries in the store */
+    int count() const;
+
+    /**
+     * @brief File size up to the end of an entry's record
+     * @param index 0 for the oldest entry; must be below count()
+     */
+    qint64 endOf(int index) const;
+
+    /**
+     * @brief Decodes one entry
+     * @param index 0 for the oldest entry
+     * @param entry Receives it
+     * @param withGrids False to skip unpacking the grid and the givens
+     * @return False if the index is out of range or the record is damaged
+     */
+    bool entry(int index, Entry &entry, bool withGrids = true) const;
+
+    /**
+     * @brief Appends one entry, creating the file and its folder if needed
+     * @param entry Entry to store; its grid must be valid, and the givens
+     *        (if valid) must have the grid's box size
+     * @return False if the entry is malformed or the write failed
+     */
+    bool append(const Entry &entry);
+
+    /**
+     * @brief Appends several entries with a single write
+     * @return False, with nothing appended, if one of them is malformed or
+     *         the write failed
+     */
+    bool append(const std::vector<Entry> &entries);
+
+    /**
+     * @brief Waits until everything appended so far is on the disk
+     * @return False if the data could not be synced
+     */
+    bool sync();
+
+    /**
+     * @brief Picks up records other writers appended since the last look
+     * @return Entries added; -1 if the file shrank, was rewritten or was
+     *         replaced, after which the store has been reopened from scratch
+     *
+     * Only the bytes past the last indexed record are read, and nothing is
+     * written, so this is cheap enough to call on every change
+     * notification.
+     */
+    int refresh();
+
+    /** @brief Store file */
+    QString path() const;
+
+    /** @brief Location of the user's history store */
+    static QString defaultPath();
+
+    /** @brief Location of the offset index belonging to a store */
+    static QString offsetsPathFor(const QString &storePath);
+
+    /**
+     * @brief Converts a legacy text history into a new store
+     * @param textPath History in the format SudokuGenerator wrote before the store
+     * @param storePath Store to create; written to a temporary file and
+     *        moved into place only when complete
+     * @param stop Once set, the migration is abandoned and nothing is written
+     * @return Entries migrated, or -1 if either file could not be used or
+     *         the migration was stopped
+     *
+     * The text is read one entry at a time, so memory use does not grow
+     * with the size of the history.
+     */
+    static int migrateLegacy(const QString &textPath, const QString &storePath,
+                             const std::atomic<bool> *stop = nullptr);
+
+    /**
+     * @brief Migrates the user's legacy history unless a store already exists
+     * @param stop Passed on to migrateLegacy(); a stopped migration is
+     *        started over by the next call
+     * @return defaultPath()
+     *
+     * The text file is left where it is; the store is used from then on.
+     * Safe to call from several threads: a second caller waits for a
+     * migration in progress instead of starting its own.
+     */
+    static QString migrateDefaultHistory(const std::atomic<bool> *stop = nullptr);
+
+private:
+    /**
+     * @brief Validates records from an offset on and adds them to the index
+     * @param from Where the first unindexed record starts
+     * @return Offset just past the last valid record
+     */
+    qint64 scan(qint64 from);
+
+    /** @brief Maps at least the first size bytes of the file */
+    bool ensureMapped(qint64 size) const;
+
+    /** @brief Drops the current mapping */
+    void unmap() const;
+
+    /** @brief Reads the offset index; false if it is missing or does not fit */
+    bool loadOffsets();
+
+    /**
+     * @brief Whether the last indexed record is still intact and ends at
+     * m_end, i.e. the indexed part of the file was not rewritten
+     */
+    bool tailIntact() const;
+
+    /**
+     * @brief Appends offsets to the index and records the covered size,
+     * or replaces the index if it does not end where they start
+     */
+    void appendOffsets(std::size_t first) const;
+
+    QString m_path;
+    mutable QFile m_file;
+    mutable uchar *m_map;
+    mutable qint64 m_mappedSize;
+    std::vector<qint64> m_offsets; ///< Start of every record, in file order
+    qint64 m_end;                  ///< End of the last valid record
+};
+
+#endif // HISTORYSTORE_H
@@ -0,0 +1,158 @@
+/**
+ * @file HistoryWriter.cpp
+ * @brief Implementation of the HistoryWriter class
+ */
+
+#include "HistoryWriter.h"
+#include <QDebug>
+
+namespace {
+
+/** @brief Set by forDefaultStore() once its writer exists */
+std::atomic<HistoryWriter *> g_defaultWriter{nullptr};
+
+} // namespace
+
+/**
+ * Constructor for HistoryWriter
+ * The store is opened on the writer thread, so a slow disk never holds up
+ * the caller
+ */
+HistoryWriter::HistoryWriter(const QString &storePath, SyncPolicy policy)
+    : HistoryWriter(storePath, policy, false)
+{
+}
+
+HistoryWriter::HistoryWriter(const QString &storePath, SyncPolicy policy, bool migrate)
+    : m_path(storePath),
+      m_policy(policy),
+      m_migrate(migrate),
+      m_flushRequested(false),
+      m_stopping(false)
+{
+    m_thread = std::thread(&HistoryWriter::run, this);
+}
+
+/**
+ * Destructor for HistoryWriter
+ * Flushes first so no queued game is lost
+ */
+HistoryWriter::~HistoryWriter()
+{
+    HistoryWriter *self = this;
+    g_defaultWriter.compare_exchange_strong(self, nullptr);
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    m_space.notify_all();
+    m_thread.join();
+}
+
+bool HistoryWriter::enqueue(const HistoryStore::Entry &entry, Written written)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_space.wait(lock, [this]() {
+        return static_cast<int>(m_queue.size()) < QUEUE_CAPACITY || m_stopping;
+    });
+    if (m_stopping) {
+        return false;
+    }
+    m_queue.push_back({entry, std::move(written)});
+    m_wake.notify_one();
+    return true;
+}
+
+void HistoryWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_flushRequested = true;
+    m_wake.notify_one();
+    m_idle.wait(lock, [this]() { return !m_flushRequested; });
+}
+
+/**
+ * Function-local, so it is started by the first save and destroyed, after
+ * a final flush, at exit
+ */
+HistoryWriter &HistoryWriter::forDefaultStore()
+{
+    static HistoryWriter writer(HistoryStore::defaultPath(), SyncEachBatch, true);
+    g_defaultWriter.store(&writer);
+    return writer;
+}
+
+HistoryWriter *HistoryWriter::defaultStoreIfStarted()
+{
+    return g_defaultWriter.load();
+}
+
+/**
+ * The queue is always emptied before a flush is answered, so a flush
+ * covers every entry queued before it
+ */
+void HistoryWriter::run()
+{
+    if (m_migrate) {
+        // Waits for a migration already running elsewhere, so it cannot
+        // replace the store under the writer
+        HistoryStore::migrateDefaultHistory();
+    }
+    HistoryStore store(m_path);
+    store.open();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [this]() { return !m_queue.empty() || m_flushRequested || m_stopping; });
+
+        if (!m_queue.empty()) {
+            std::vector<Pending> batch;
+            batch.swap(m_queue);
+            lock.unlock();
+            m_space.notify_all();
+            writeBatch(store, batch);
+            lock.lock();
+            continue;
+        }
+
+        if (m_flushRequested) {
+            lock.unlock();
+            if (m_policy != SyncNever && !store.sync()) {
+                qDebug() << "Could not sync history store:" << m_path;
+            }
+            lock.lock();
+            m_flushRequested = false;
+            m_idle.notify_all();
+            continue;
+        }
+
+        if (m_stopping) {
+            return;
+        }
+    }
+}
+
+void HistoryWriter::writeBatch(HistoryStore &store, std::vector<Pending> &batch)
+{
+    std::vector<HistoryStore::Entry> entries;
+    entries.reserve(batch.size());
+    for (const Pending &pending : batch) {
+        entries.push_back(pending.entry);
+    }
+
+    if (!store.append(entries)) {
+        qDebug() << "Could not write" << entries.size() << "history entries to" << m_path;
+        return;
+    }
+    if (m_policy == SyncEachBatch && !store.sync()) {
+        qDebug() << "Could not sync history store:" << m_path;
+    }
+    const int first = store.count() - static_cast<int>(batch.size());
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        if (batch[i].written) {
+            batch[i].written(store.endOf(first + static_cast<int>(i)));
+        }
+    }
+}
@@ -0,0 +1,129 @@
+/**
+ * @file HistoryWriter.h
+ * @brief Header file for the HistoryWriter class, the background history writer
+ *
+ * This class is responsible for:
+ * - Taking finished games off the GUI thread into a bounded queue
+ * - Writing everything queued in one append on its own thread
+ * - Syncing the store to disk according to a policy
+ * - Draining the queue before the application exits
+ */
+
+#ifndef HISTORYWRITER_H
+#define HISTORYWRITER_H
+
+#include <QString>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "HistoryStore.h"
+
+/**
+ * @class HistoryWriter
+ * @brief Single writer thread in front of a HistoryStore
+ *
+ * enqueue() only copies the entry into the queue; the thread owns its own
+ * HistoryStore and appends whatever has piled up since its last write as
+ * one batch. The store's records are checksummed, so a batch cut short by
+ * a crash is detected and dropped the next time the store is opened.
+ *
+ * The queue holds at most QUEUE_CAPACITY entries; enqueue() waits for room
+ * rather than dropping a game, which only happens if the disk stalls for
+ * that many saves.
+ */
+class HistoryWriter
+{
+public:
+    /** @brief When the store is synced to disk */
+    enum SyncPolicy {
+        SyncEachBatch, ///< After every batch (default)
+        SyncOnFlush,   ///< Only in flush() and on destruction
+        SyncNever      ///< Left to the operating system
+    };
+
+    /**
+     * @brief Called on the writer thread once an entry is in the store, with
+     * the store's size up to the end of that entry
+     */
+    using Written = std::function<void(qint64 storeSize)>;
+
+    /** @brief Entries the queue holds before enqueue() waits */
+    static constexpr int QUEUE_CAPACITY = 64;
+
+    /**
+     * @brief Starts the writer thread
+     * @param storePath HistoryStore file, created by the first write
+     * @param policy When to sync
+     */
+    explicit HistoryWriter(const QString &storePath, SyncPolicy policy = SyncEachBatch);
+
+    /**
+     * @brief Writes and syncs everything queued, then joins the thread
+     */
+    ~HistoryWriter();
+
+    HistoryWriter(const HistoryWriter &) = delete;
+    HistoryWriter &operator=(const HistoryWriter &) = delete;
+
+    /**
+     * @brief Queues an entry; safe to call from any thread
+     * @param entry Entry to append
+     * @param written Run on the writer thread after the entry was written
+     *        (not if the write failed)
+     * @return False if the writer is shutting down
+     */
+    bool enqueue(const HistoryStore::Entry &entry, Written written = Written());
+
+    /**
+     * @brief Blocks until everything queued so far is written and, unless
+     * the policy is SyncNever, synced
+     */
+    void flush();
+
+    /**
+     * @brief The writer for HistoryStore::defaultPath(), started on first use
+     *
+     * Its thread migrates the legacy text history before opening the store,
+     * so the first save does not wait for that either.
+     */
+    static HistoryWriter &forDefaultStore();
+
+    /**
+     * @brief The writer of forDefaultStore() if it has been started, else null
+     */
+    static HistoryWriter *defaultStoreIfStarted();
+
+private:
+    /** @brief Starts the writer thread, which migrates first if asked to */
+    HistoryWriter(const QString &storePath, SyncPolicy policy, bool migrate);
+
+    /** @brief A queued entry and its completion callback */
+    struct Pending {
+        HistoryStore::Entry entry;
+        Written written;
+    };
+
+    /** @brief Thread main loop: write batches, honour flush requests, stop */
+    void run();
+
+    /** @brief Appends one batch and runs its callbacks */
+    void writeBatch(HistoryStore &store, std::vector<Pending> &batch);
+
+    const QString m_path;
+    const SyncPolicy m_policy;
+    const bool m_migrate; ///< Run HistoryStore::migrateDefaultHistory() first
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;  ///< Signalled on enqueue, flush and shutdown
+    std::condition_variable m_space; ///< Signalled when a batch leaves the queue
+    std::condition_variable m_idle;  ///< Signalled when a flush completes
+    std::vector<Pending> m_queue;
+    bool m_flushRequested;
+    bool m_stopping;
+    std::thread m_thread;
+};
+
+#endif // HISTORYWRITER_H
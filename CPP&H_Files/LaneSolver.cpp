@@ -0,0 +1,308 @@
+/**
+ * @file LaneSolver.cpp
+ * @brief Implementation of the LaneSolver class
+ */
+
+#include "LaneSolver.h"
+#include <QtAlgorithms>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LANESOLVER_X86_DISPATCH 1
+#endif
+
+namespace {
+
+constexpr int kLanes = LaneSolver::LANES;
+constexpr std::uint16_t kAllDigits = 0x1FF;
+constexpr int kMaxSweeps = 81;
+
+#ifdef LANESOLVER_X86_DISPATCH
+// 16 x 16-bit lanes; lowered to one AVX2 register, two SSE registers, or
+// whatever the enclosing function's target allows
+typedef std::uint16_t LaneVector __attribute__((vector_size(32)));
+#define LANE_INLINE static inline __attribute__((always_inline))
+// Vector-returning helpers are always inlined into their target-specific
+// callers, so the cross-ISA calling convention warning does not apply
+#pragma GCC diagnostic ignored "-Wpsabi"
+#else
+// Portable fallback with the same operators, left to the auto-vectorizer
+struct LaneVector {
+    std::uint16_t v[kLanes];
+};
+#define LANE_BINARY_OP(op)                                                   \
+    inline LaneVector operator op(const LaneVector &a, const LaneVector &b) { \
+        LaneVector r;                                                        \
+        for (int l = 0; l < kLanes; ++l) r.v[l] = std::uint16_t(a.v[l] op b.v[l]); \
+        return r;                                                            \
+    }
+LANE_BINARY_OP(&)
+LANE_BINARY_OP(|)
+LANE_BINARY_OP(^)
+LANE_BINARY_OP(-)
+#undef LANE_BINARY_OP
+inline LaneVector operator~(const LaneVector &a) {
+    LaneVector r;
+    for (int l = 0; l < kLanes; ++l) r.v[l] = std::uint16_t(~a.v[l]);
+    return r;
+}
+inline LaneVector operator==(const LaneVector &a, const LaneVector &b) {
+    LaneVector r;
+    for (int l = 0; l < kLanes; ++l) r.v[l] = a.v[l] == b.v[l] ? 0xFFFF : 0;
+    return r;
+}
+inline LaneVector operator!=(const LaneVector &a, const LaneVector &b) { return ~(a == b); }
+#define LANE_INLINE static inline
+#endif
+
+// Lane accessor shared by both representations
+#ifndef LANESOLVER_X86_DISPATCH
+#define LANE_AT(vec, l) (vec).v[l]
+#else
+#define LANE_AT(vec, l) (vec)[l]
+#endif
+
+LANE_INLINE LaneVector splat(std::uint16_t value)
+{
+    LaneVector r;
+    for (int l = 0; l < kLanes; ++l) {
+        LANE_AT(r, l) = value;
+    }
+    return r;
+}
+
+/**
+ * @brief The 20 peers of every cell and the 9 cells of every unit
+ */
+struct Tables {
+    std::array<std::array<std::uint8_t, 20>, 81> peers{};
+    std::array<std::array<std::uint8_t, 9>, 27> units{};
+};
+
+constexpr Tables makeTables()
+{
+    Tables t{};
+    for (int i = 0; i < 9; ++i) {
+        for (int j = 0; j < 9; ++j) {
+            t.units[i][j] = static_cast<std::uint8_t>(i * 9 + j);
+            t.units[9 + i][j] = static_cast<std::uint8_t>(j * 9 + i);
+            t.units[18 + i][j] = static_cast<std::uint8_t>(((i / 3) * 3 + j / 3) * 9 + (i % 3) * 3 + j % 3);
+        }
+    }
+    for (int cell = 0; cell < 81; ++cell) {
+        const int r = cell / 9;
+        const int c = cell % 9;
+        int n = 0;
+        for (int other = 0; other < 81; ++other) {
+            const int orow = other / 9;
+            const int ocol = other % 9;
+            const bool peer = other != cell
+                && (orow == r || ocol == c || (orow / 3 == r / 3 && ocol / 3 == c / 3));
+            if (peer) {
+                t.peers[cell][n++] = static_cast<std::uint8_t>(other);
+            }
+        }
+    }
+    return t;
+}
+
+constexpr Tables kTables = makeTables();
+
+/**
+ * @brief Lockstep propagation over all lanes
+ *
+ * Each sweep removes every naked single from its peers, then promotes every
+ * hidden single; sweeps repeat until no lane changes. Returns a per-lane
+ * contradiction mask (all ones where a lane is dead).
+ */
+LANE_INLINE LaneVector propagateLanes(LaneVector *cand)
+{
+    const LaneVector zero = splat(0);
+    const LaneVector one = splat(1);
+    const LaneVector all = splat(kAllDigits);
+    LaneVector dead = zero;
+
+    for (int sweep = 0; sweep < kMaxSweeps; ++sweep) {
+        LaneVector changed = zero;
+
+        // Naked singles: strip every decided digit from the cell's peers
+        for (int cell = 0; cell < 81; ++cell) {
+            const LaneVector v = cand[cell];
+            const LaneVector single = v & ((v & (v - one)) == zero);
+            const LaneVector keep = ~single;
+            for (int p = 0; p < 20; ++p) {
+                LaneVector &peer = cand[kTables.peers[cell][p]];
+                const LaneVector reduced = peer & keep;
+                changed |= peer ^ reduced;
+                peer = reduced;
+            }
+        }
+
+        // Hidden singles: a digit with one home in a unit is fixed there
+        for (int u = 0; u < 27; ++u) {
+            LaneVector once = zero;
+            LaneVector twice = zero;
+            for (int k = 0; k < 9; ++k) {
+                const LaneVector v = cand[kTables.units[u][k]];
+                twice |= once & v;
+                once |= v;
+            }
+            dead |= (once != all);
+
+            const LaneVector hidden = once & ~twice;
+            for (int k = 0; k < 9; ++k) {
+                LaneVector &v = cand[kTables.units[u][k]];
+                const LaneVector h = v & hidden;
+                const LaneVector take = (h != zero) & (h != v);
+                const LaneVector next = (h & take) | (v & ~take);
+                changed |= v ^ next;
+                v = next;
+            }
+        }
+
+        for (int cell = 0; cell < 81; ++cell) {
+            dead |= (cand[cell] == zero);
+        }
+
+        // Stop once no lane that is still alive made progress
+        const LaneVector live = changed & ~dead;
+        bool any = false;
+        for (int l = 0; l < kLanes; ++l) {
+            any = any || LANE_AT(live, l) != 0;
+        }
+        if (!any) {
+            break;
+        }
+    }
+    return dead;
+}
+
+void propagateGeneric(LaneVector *cand, LaneVector &dead)
+{
+    dead = propagateLanes(cand);
+}
+
+#ifdef LANESOLVER_X86_DISPATCH
+__attribute__((target("avx2"))) void propagateAvx2(LaneVector *cand, LaneVector &dead)
+{
+    dead = propagateLanes(cand);
+}
+
+__attribute__((target("sse4.2"))) void propagateSse42(LaneVector *cand, LaneVector &dead)
+{
+    dead = propagateLanes(cand);
+}
+#endif
+
+using PropagateFunction = void (*)(LaneVector *, LaneVector &);
+
+/**
+ * @brief Picks the widest kernel the CPU supports, once
+ */
+PropagateFunction selectKernel(const char **name)
+{
+#ifdef LANESOLVER_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        *name = "avx2";
+        return propagateAvx2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        *name = "sse4.2";
+        return propagateSse42;
+    }
+#endif
+    *name = "generic";
+    return propagateGeneric;
+}
+
+const char *g_kernelName = nullptr;
+const PropagateFunction g_kernel = selectKernel(&g_kernelName);
+
+} // namespace
+
+/**
+ * Solves puzzles LANES at a time: load, propagate in lockstep, then decode
+ * each lane or finish it on the scalar Solver
+ */
+std::size_t LaneSolver::solveMany(const Board *puzzles, Board *solutions, std::size_t count,
+                                  bool *solved)
+{
+    std::size_t solvedCount = 0;
+    std::array<LaneVector, 81> cand;
+
+    for (std::size_t base = 0; base < count; base += kLanes) {
+        const int used = static_cast<int>(std::min<std::size_t>(kLanes, count - base));
+
+        // Load: givens become single bits; padding lanes repeat the first puzzle.
+        // A value above 9 is propagated as blank but its lane is rejected
+        std::array<bool, kLanes> malformed{};
+        for (int cell = 0; cell < 81; ++cell) {
+            for (int l = 0; l < kLanes; ++l) {
+                const Board &board = puzzles[base + (l < used ? l : 0)];
+                const std::uint8_t value = board[cell];
+                malformed[l] = malformed[l] || value > 9;
+                LANE_AT(cand[cell], l) = (value >= 1 && value <= 9)
+                    ? static_cast<std::uint16_t>(1u << (value - 1)) : kAllDigits;
+            }
+        }
+
+        LaneVector dead;
+        g_kernel(cand.data(), dead);
+
+        for (int l = 0; l < used; ++l) {
+            const std::size_t index = base + l;
+            Board result{};
+            bool ok = !malformed[l] && LANE_AT(dead, l) == 0;
+            bool complete = true;
+
+            // Decode decided cells; everything else is left for the scalar search
+            for (int cell = 0; cell < 81 && ok; ++cell) {
+                const std::uint16_t mask = LANE_AT(cand[cell], l);
+                if ((mask & (mask - 1)) == 0) {
+                    result[cell] = static_cast<std::uint8_t>(qCountTrailingZeroBits(mask) + 1);
+                } else {
+                    complete = false;
+                }
+            }
+
+            // Keep the caller's original givens authoritative (rejects bad input),
+            // whether propagation finished the grid or not
+            for (int cell = 0; cell < 81 && ok; ++cell) {
+                ok = puzzles[index][cell] == 0 || result[cell] == puzzles[index][cell];
+            }
+            if (ok && !complete) {
+                ok = Solver::solveCells(result);
+            }
+
+            if (!ok) {
+                result.fill(0);
+            }
+            solutions[index] = result;
+            if (solved) {
+                solved[index] = ok;
+            }
+            solvedCount += ok ? 1 : 0;
+        }
+    }
+    return solvedCount;
+}
+
+/**
+ * Vector overload
+ */
+std::size_t LaneSolver::solveMany(const std::vector<Board> &puzzles, std::vector<Board> &solutions)
+{
+    solutions.resize(puzzles.size());
+    return solveMany(puzzles.data(), solutions.data(), puzzles.size());
+}
+
+/**
+ * Name of the kernel chosen at startup
+ */
+const char *LaneSolver::instructionSet()
+{
+    return g_kernelName;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file LaneSolver.h
+ * @brief Header file for the LaneSolver class, a lane-parallel bulk solver
+ *
+ * This class is responsible for:
+ * - Packing 16 independent puzzles into the lanes of one vector register set
+ * - Running candidate elimination and singles detection on all lanes in lockstep
+ * - Handing lanes that still need guessing to the scalar Solver
+ */
+
+#ifndef LANESOLVER_H
+#define LANESOLVER_H
+
+#include "Solver.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class LaneSolver
+ * @brief Batch solving kernel that propagates many puzzles at once
+ *
+ * Candidates are stored structure-of-arrays: for each of the 81 cells one
+ * vector holds that cell's 16-bit candidate mask in every lane. Naked-single
+ * elimination and hidden singles then become plain AND/OR/compare sequences
+ * across all lanes. The kernel is compiled for AVX2, SSE4.2 and the baseline
+ * instruction set and the best one is picked at runtime. Lanes that are not
+ * solved by propagation alone fall back to Solver::solveCells, seeded with
+ * everything the kernel already deduced. Only standard (non-diagonal) rules
+ * are supported.
+ */
+class LaneSolver
+{
+public:
+    /** @brief Flat row-major board, 0 for empty cells */
+    using Board = Solver::Cells;
+
+    /** @brief Puzzles propagated together by one kernel call */
+    static constexpr int LANES = 16;
+
+    /**
+     * @brief Solves a batch of puzzles
+     * @param puzzles First of count input boards
+     * @param solutions First of count output boards (may alias puzzles);
+     *        unsolvable entries are left all zero
+     * @param count Number of boards
+     * @param solved Optional array of count flags, true where a solution was found
+     * @return Number of puzzles solved
+     */
+    static std::size_t solveMany(const Board *puzzles, Board *solutions, std::size_t count,
+                                 bool *solved = nullptr);
+
+    /**
+     * @brief Convenience overload; resizes solutions to match puzzles
+     * @param puzzles Input boards
+     * @param solutions Output boards
+     * @return Number of puzzles solved
+     */
+    static std::size_t solveMany(const std::vector<Board> &puzzles, std::vector<Board> &solutions);
+
+    /**
+     * @brief Instruction set the kernel runs with on this machine
+     * @return "avx2", "sse4.2" or "generic"
+     */
+    static const char *instructionSet();
+};
+
+#endif // LANESOLVER_H
@@ -0,0 +1,369 @@
+/**
+ * @file LegacyHistoryParser.cpp
+ * @brief Implementation of the LegacyHistoryParser class
+ */
+
+#include "LegacyHistoryParser.h"
+#include <QFile>
+#include <climits>
+#include <cstring>
+
+namespace {
+
+const char ENTRY_HEADER[] = "--- Puzzle Entry ---";
+const char DATE_PREFIX[] = "Date: ";
+const char TIME_PREFIX[] = "Completion Time (seconds): ";
+const char DIFFICULTY_PREFIX[] = "Difficulty: ";
+const char PUZZLE_LINE[] = "Puzzle:";
+const char GIVENS_LINE[] = "Givens:";
+
+/** @brief Whitespace as QString::trimmed sees it, within ASCII */
+bool isSpace(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+QByteArrayView trimmed(QByteArrayView text)
+{
+    const char *begin = text.data();
+    const char *end = begin + text.size();
+    while (begin < end && isSpace(*begin)) {
+        ++begin;
+    }
+    while (end > begin && isSpace(end[-1])) {
+        --end;
+    }
+    return QByteArrayView(begin, end - begin);
+}
+
+template <std::size_t N>
+bool equals(QByteArrayView text, const char (&literal)[N])
+{
+    return text.size() == static_cast<qsizetype>(N - 1) && std::memcmp(text.data(), literal, N - 1) == 0;
+}
+
+template <std::size_t N>
+bool startsWith(QByteArrayView text, const char (&literal)[N])
+{
+    return text.size() >= static_cast<qsizetype>(N - 1) && std::memcmp(text.data(), literal, N - 1) == 0;
+}
+
+/**
+ * @brief QString::toInt on a token: surrounding whitespace and a sign are
+ * accepted, anything else that is not a digit, or an overflow, gives 0
+ */
+int toInt(QByteArrayView token)
+{
+    token = trimmed(token);
+    const char *digit = token.data();
+    const char *end = digit + token.size();
+    bool negative = false;
+    if (digit < end && (*digit == '+' || *digit == '-')) {
+        negative = *digit == '-';
+        ++digit;
+    }
+    if (digit == end) {
+        return 0;
+    }
+
+    long long value = 0;
+    for (; digit < end; ++digit) {
+        if (*digit < '0' || *digit > '9') {
+            return 0;
+        }
+        value = value * 10 + (*digit - '0');
+        if (value > static_cast<long long>(INT_MAX) + 1) {
+            return 0;
+        }
+    }
+    value = negative ? -value : value;
+    return (value < INT_MIN || value > INT_MAX) ? 0 : static_cast<int>(value);
+}
+
+} // namespace
+
+QByteArrayView LegacyHistoryParser::Entry::date() const
+{
+    return QByteArrayView(m_date.data(), static_cast<qsizetype>(m_date.size()));
+}
+
+int LegacyHistoryParser::Entry::time() const
+{
+    return m_time;
+}
+
+int LegacyHistoryParser::Entry::difficulty() const
+{
+    return m_difficulty;
+}
+
+bool LegacyHistoryParser::Entry::hasGivens() const
+{
+    return !m_givens.ends.empty();
+}
+
+Board LegacyHistoryParser::Entry::grid() const
+{
+    return m_grid.toBoard();
+}
+
+Board LegacyHistoryParser::Entry::givens() const
+{
+    return m_givens.toBoard();
+}
+
+QVariantMap LegacyHistoryParser::Entry::toVariantMap() const
+{
+    QVariantMap entry;
+    entry["date"] = QString::fromUtf8(m_date.data(), static_cast<qsizetype>(m_date.size()));
+    entry["time"] = m_time;
+    entry["difficulty"] = m_difficulty;
+    entry["grid"] = m_grid.toVariantList();
+    if (hasGivens()) {
+        entry["givens"] = m_givens.toVariantList();
+    }
+    return entry;
+}
+
+void LegacyHistoryParser::Entry::Rows::clear()
+{
+    values.clear();
+    ends.clear();
+}
+
+/**
+ * Same checks as Board::fromVariantList, on the flat rows
+ */
+Board LegacyHistoryParser::Entry::Rows::toBoard() const
+{
+    const int side = static_cast<int>(ends.size());
+    int boxSize = 0;
+    for (int box = 2; box <= 5; ++box) {
+        if (box * box == side) {
+            boxSize = box;
+        }
+    }
+    Board board(boxSize);
+    if (!board.isValid()) {
+        return Board();
+    }
+
+    std::uint8_t *cells = board.cells();
+    int start = 0;
+    for (int r = 0; r < side; ++r) {
+        if (ends[r] - start != side) {
+            return Board();
+        }
+        for (int c = 0; c < side; ++c) {
+            const int value = values[start + c];
+            if (value < 0 || value > side) {
+                return Board();
+            }
+            cells[r * side + c] = static_cast<std::uint8_t>(value);
+        }
+        start = ends[r];
+    }
+    return board;
+}
+
+QVariantList LegacyHistoryParser::Entry::Rows::toVariantList() const
+{
+    QVariantList rows;
+    rows.reserve(static_cast<int>(ends.size()));
+    int start = 0;
+    for (int end : ends) {
+        QVariantList row;
+        row.reserve(end - start);
+        for (int i = start; i < end; ++i) {
+            row.append(values[i]);
+        }
+        rows.append(QVariant(row));
+        start = end;
+    }
+    return rows;
+}
+
+LegacyHistoryParser::LegacyHistoryParser(const Callback &callback)
+    : m_callback(callback),
+      m_state(State::Seeking),
+      m_size(0)
+{
+}
+
+/**
+ * Complete lines are handed over straight from the buffer; the unfinished
+ * last line is moved to its front before the next read
+ */
+bool LegacyHistoryParser::parseFile(const QString &filePath, const Callback &callback,
+                                    const std::atomic<bool> *stop)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    LegacyHistoryParser parser(callback);
+    QByteArray buffer(CHUNK_SIZE, '\0');
+    qint64 filled = 0;
+    for (;;) {
+        if (stop && stop->load(std::memory_order_relaxed)) {
+            return false;
+        }
+        const qint64 read = file.read(buffer.data() + filled, buffer.size() - filled);
+        if (read < 0) {
+            return false;
+        }
+        filled += read;
+
+        const char *line = buffer.constData();
+        const char *end = line + filled;
+        while (const char *newline = static_cast<const char *>(std::memchr(line, '\n', end - line))) {
+            parser.feedLine(line, newline);
+            line = newline + 1;
+        }
+
+        const qint64 rest = end - line;
+        if (read == 0) {
+            if (rest > 0) {
+                parser.feedLine(line, end); // Last line without a newline
+            }
+            break;
+        }
+        std::memmove(buffer.data(), line, static_cast<std::size_t>(rest));
+        filled = rest;
+        if (filled == buffer.size()) {
+            buffer.resize(buffer.size() * 2); // A line longer than the buffer
+        }
+    }
+    parser.finish();
+    return true;
+}
+
+void LegacyHistoryParser::feedLine(const char *begin, const char *end)
+{
+    if (!std::memchr(begin, '\r', end - begin)) {
+        process(QByteArrayView(begin, end - begin));
+        return;
+    }
+    m_scratch.clear();
+    for (const char *c = begin; c < end; ++c) {
+        if (*c != '\r') {
+            m_scratch.push_back(*c);
+        }
+    }
+    process(QByteArrayView(m_scratch.data(), static_cast<qsizetype>(m_scratch.size())));
+}
+
+/**
+ * An optional line that does not match moves on to the next state with the
+ * same line, as the old parser moved on without advancing its line index
+ */
+void LegacyHistoryParser::process(QByteArrayView line)
+{
+    // Splits a row on single spaces, like QString::split(" ", Qt::SkipEmptyParts)
+    const auto appendRow = [](QByteArrayView text, Entry::Rows &rows) {
+        text = trimmed(text);
+        const char *token = text.data();
+        const char *end = token + text.size();
+        int count = 0;
+        while (token < end) {
+            const char *space = static_cast<const char *>(std::memchr(token, ' ', end - token));
+            const char *tokenEnd = space ? space : end;
+            if (tokenEnd > token) {
+                rows.values.push_back(toInt(QByteArrayView(token, tokenEnd - token)));
+                ++count;
+            }
+            token = tokenEnd + 1;
+        }
+        rows.ends.push_back(static_cast<int>(rows.values.size()));
+        return count;
+    };
+
+    for (;;) {
+        switch (m_state) {
+        case State::Seeking:
+            if (equals(trimmed(line), ENTRY_HEADER)) {
+                m_entry.m_date.clear();
+                m_entry.m_time = 0;
+                m_entry.m_difficulty = 0;
+                m_entry.m_grid.clear();
+                m_entry.m_givens.clear();
+                m_size = 9;
+                m_state = State::Date;
+            }
+            return;
+
+        case State::Date:
+            m_state = State::Time;
+            if (startsWith(line, DATE_PREFIX)) {
+                const QByteArrayView date = trimmed(line.sliced(sizeof(DATE_PREFIX) - 1));
+                m_entry.m_date.assign(date.data(), static_cast<std::size_t>(date.size()));
+                return;
+            }
+            break;
+
+        case State::Time:
+            m_state = State::Difficulty;
+            if (startsWith(line, TIME_PREFIX)) {
+                m_entry.m_time = toInt(line.sliced(sizeof(TIME_PREFIX) - 1));
+                return;
+            }
+            break;
+
+        case State::Difficulty:
+            m_state = State::Puzzle;
+            if (startsWith(line, DIFFICULTY_PREFIX)) {
+                m_entry.m_difficulty = toInt(line.sliced(sizeof(DIFFICULTY_PREFIX) - 1));
+                return;
+            }
+            break;
+
+        case State::Puzzle:
+            m_state = State::Grid;
+            if (equals(trimmed(line), PUZZLE_LINE)) {
+                return;
+            }
+            break;
+
+        case State::Grid: {
+            // The grid is square, so the first row gives the size
+            const int cells = appendRow(line, m_entry.m_grid);
+            if (m_entry.m_grid.ends.size() == 1 && cells > 0) {
+                m_size = cells;
+            }
+            if (static_cast<int>(m_entry.m_grid.ends.size()) >= m_size) {
+                m_state = State::GivensHeader;
+            }
+            return;
+        }
+
+        case State::GivensHeader:
+            if (equals(trimmed(line), GIVENS_LINE)) {
+                m_state = State::Givens;
+                return;
+            }
+            emitEntry(); // Not part of this entry; maybe the next header
+            break;
+
+        case State::Givens:
+            appendRow(line, m_entry.m_givens);
+            if (static_cast<int>(m_entry.m_givens.ends.size()) >= m_size) {
+                emitEntry();
+            }
+            return;
+        }
+    }
+}
+
+void LegacyHistoryParser::finish()
+{
+    if (m_state != State::Seeking) {
+        emitEntry();
+    }
+}
+
+void LegacyHistoryParser::emitEntry()
+{
+    m_state = State::Seeking;
+    m_callback(m_entry);
+}
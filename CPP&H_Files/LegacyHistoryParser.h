@@ -0,0 +1,148 @@
+/**
+ * @file LegacyHistoryParser.h
+ * @brief Header file for the LegacyHistoryParser class, a streaming reader
+ * of the text history format
+ *
+ * This class is responsible for:
+ * - Reading the text history SudokuGenerator wrote before the HistoryStore
+ *   in fixed-size chunks, whatever the size of the file
+ * - Tokenizing lines and digits in place, without per-line or per-cell
+ *   allocations
+ * - Reproducing exactly the entries the old line-by-line parser produced
+ */
+
+#ifndef LEGACYHISTORYPARSER_H
+#define LEGACYHISTORYPARSER_H
+
+#include <QByteArrayView>
+#include <QString>
+#include <QVariantMap>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Board.h"
+
+/**
+ * @class LegacyHistoryParser
+ * @brief Line-driven state machine over the text history
+ *
+ * An entry is a "--- Puzzle Entry ---" line followed by optional "Date: ",
+ * "Completion Time (seconds): " and "Difficulty: " lines, an optional
+ * "Puzzle:" line, the grid rows (as many as the first row has numbers) and
+ * optionally "Givens:" with as many rows again. Each optional line is only
+ * consumed if it matches; a grid row is consumed whatever it holds. Lines
+ * outside entries are skipped. This is how the old QStringList parser read
+ * the format, malformed files included.
+ *
+ * The file is read through one CHUNK_SIZE buffer (larger only for a line
+ * longer than that). The Entry handed to the callback reuses its buffers
+ * from one entry to the next, so nothing is allocated per entry once they
+ * have grown to the largest grid.
+ */
+class LegacyHistoryParser
+{
+public:
+    /** @brief One parsed entry; valid only during the callback */
+    class Entry
+    {
+    public:
+        /** @brief Text after "Date: ", trimmed; empty if there was no date line */
+        QByteArrayView date() const;
+
+        /** @brief Completion time, 0 if missing or not a number */
+        int time() const;
+
+        /** @brief Difficulty, 0 if missing or not a number */
+        int difficulty() const;
+
+        /** @brief Whether a "Givens:" line with at least one row followed the grid */
+        bool hasGivens() const;
+
+        /** @brief The grid, invalid unless its rows form a supported square */
+        Board grid() const;
+
+        /** @brief The givens, invalid if absent or not a supported square */
+        Board givens() const;
+
+        /**
+         * @brief The entry as HistoryRead::readHistoryFile returns it: "date",
+         * "time", "difficulty" and "grid" rows (possibly ragged), plus
+         * "givens" when present
+         */
+        QVariantMap toVariantMap() const;
+
+    private:
+        friend class LegacyHistoryParser;
+
+        /** @brief Rows of numbers, flattened, with where each row ends */
+        struct Rows {
+            std::vector<int> values;
+            std::vector<int> ends;
+
+            void clear();
+            Board toBoard() const;
+            QVariantList toVariantList() const;
+        };
+
+        std::string m_date;
+        int m_time = 0;
+        int m_difficulty = 0;
+        Rows m_grid;
+        Rows m_givens;
+    };
+
+    /** @brief Receives each entry in file order */
+    using Callback = std::function<void(const Entry &entry)>;
+
+    /** @brief Bytes read from the file at a time */
+    static constexpr int CHUNK_SIZE = 1 << 20;
+
+    /**
+     * @brief Parses a text history
+     * @param filePath History file
+     * @param callback Called once per entry
+     * @param stop Checked before each chunk; once set, parsing gives up
+     * @return False if the file could not be opened or read, or was stopped
+     */
+    static bool parseFile(const QString &filePath, const Callback &callback,
+                          const std::atomic<bool> *stop = nullptr);
+
+private:
+    /** @brief Where the next line goes */
+    enum class State {
+        Seeking,       ///< Outside an entry
+        Date,          ///< After the entry header
+        Time,
+        Difficulty,
+        Puzzle,        ///< Optional "Puzzle:" line
+        Grid,          ///< Grid rows
+        GivensHeader,  ///< Optional "Givens:" line
+        Givens         ///< Givens rows
+    };
+
+    explicit LegacyHistoryParser(const Callback &callback);
+
+    /**
+     * @brief Feeds one line without its '\n'; '\r' characters are dropped,
+     * as reading the file in text mode did
+     */
+    void feedLine(const char *begin, const char *end);
+
+    /** @brief Advances the state machine by one clean line */
+    void process(QByteArrayView line);
+
+    /** @brief Emits an entry that the end of the file cut short */
+    void finish();
+
+    /** @brief Hands the current entry to the callback and starts seeking */
+    void emitEntry();
+
+    const Callback &m_callback;
+    State m_state;
+    int m_size;          ///< Rows expected in the grid and the givens
+    Entry m_entry;
+    std::string m_scratch; ///< A line with stray '\r' characters removed
+};
+
+#endif // LEGACYHISTORYPARSER_H
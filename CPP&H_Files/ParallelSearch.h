@@ -0,0 +1,229 @@
+/**
+ * @file ParallelSearch.h
+ * @brief Tree-splitting parallel search over SudokuEngine
+ *
+ * This header is responsible for:
+ * - Splitting the top levels of the search tree into WorkStealingPool tasks
+ * - Stopping every task as soon as one finds a solution or a limit is hit
+ * - Reporting unsolvable only once every subtree has been exhausted
+ */
+
+#ifndef PARALLELSEARCH_H
+#define PARALLELSEARCH_H
+
+#include "SudokuEngine.h"
+#include "WorkStealingPool.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+/**
+ * @class ParallelSearch
+ * @brief Runs one SudokuEngine search on all workers of a pool
+ *
+ * Up to splitDepth branching levels are expanded breadth-first into tasks,
+ * one per candidate digit; below that each task runs the ordinary sequential
+ * search on its subtree. Tasks spawned by a worker land on its own deque, so
+ * workers keep descending their own part of the tree while idle ones steal
+ * the shallowest (largest) remaining subtrees.
+ *
+ * A shared stop flag is polled at every node: the first solution, the node
+ * budget or the interrupt check ends the whole search. When no task finds a
+ * solution and nothing was interrupted, the puzzle is proven unsolvable.
+ */
+template <int BoxSize>
+class ParallelSearch
+{
+public:
+    using Engine = SudokuEngine<BoxSize>;
+    using State = typename Engine::State;
+
+    /**
+     * @brief Called with the total node count every CHECK_INTERVAL nodes of a
+     * task; return true to stop the search. May run on several workers at once.
+     */
+    using InterruptCheck = std::function<bool(std::int64_t)>;
+
+    /** @brief Nodes a task visits between flushes of its count and interrupt checks */
+    static constexpr int CHECK_INTERVAL = 1024;
+
+    /**
+     * @brief Split depth that gives every worker several subtrees to steal
+     * @param threads Worker count
+     */
+    static int defaultSplitDepth(int threads)
+    {
+        int depth = 2; // Branching after propagation is mostly binary
+        while (threads > 1) {
+            threads >>= 1;
+            ++depth;
+        }
+        return depth;
+    }
+
+    /**
+     * @brief Solves on the pool's workers and blocks until the search is over
+     * @param state Start state; holds the solution on success
+     * @param diagonal Whether the diagonals are units too
+     * @param pool Workers to run on; must not be called from one of them
+     * @param splitDepth Branching levels expanded into separate tasks
+     * @param maxNodes Node budget across all tasks
+     * @param nodes Receives the nodes visited by all tasks
+     * @param check Optional interrupt check (cancellation, deadline, progress)
+     * @return True if a solution was found
+     */
+    static bool solve(State &state, bool diagonal, WorkStealingPool &pool, int splitDepth,
+                      std::int64_t maxNodes, std::int64_t &nodes,
+                      const InterruptCheck &check = {})
+    {
+        Search search(diagonal, pool, splitDepth, maxNodes, check);
+        search.spawn(state, 0);
+        search.waitForTasks();
+
+        nodes = search.nodes.load();
+        if (!search.found) {
+            return false;
+        }
+        state = search.solution;
+        return true;
+    }
+
+private:
+    /** @brief State shared by every task of one search */
+    struct Search {
+        Search(bool diagonal, WorkStealingPool &pool, int splitDepth,
+               std::int64_t maxNodes, const InterruptCheck &check)
+            : diagonal(diagonal), pool(pool), splitDepth(splitDepth),
+              maxNodes(maxNodes), check(check), stop(false), nodes(0), outstanding(0),
+              found(false)
+        {
+        }
+
+        /**
+         * @brief Queues a subtree; the search is not over while it is pending
+         */
+        void spawn(const State &subtree, int depth)
+        {
+            outstanding.fetch_add(1);
+            pool.submit([this, task = subtree, depth]() mutable {
+                run(task, depth);
+                finishTask();
+            });
+        }
+
+        void run(State &subtree, int depth)
+        {
+            if (stop.load(std::memory_order_relaxed)) {
+                return;
+            }
+
+            if (depth >= splitDepth) {
+                // Deep enough: search this subtree sequentially
+                std::int64_t local = 0;
+                const bool solved = Engine::solve(subtree, diagonal, [this, &local](int) {
+                    if (++local == CHECK_INTERVAL) {
+                        local = 0;
+                        if (interrupted(CHECK_INTERVAL)) {
+                            return true;
+                        }
+                    }
+                    return stop.load(std::memory_order_relaxed);
+                });
+                nodes.fetch_add(local);
+                if (solved) {
+                    publish(subtree);
+                }
+                return;
+            }
+
+            nodes.fetch_add(1);
+            if (!Engine::propagate(subtree, diagonal)) {
+                return; // This branch is a contradiction
+            }
+
+            int cell;
+            typename Engine::Mask options;
+            if (!Engine::findEmptyCell(subtree, cell, options)) {
+                publish(subtree); // Solved by propagation alone
+                return;
+            }
+
+            // One task per candidate; the last one stays on this worker
+            while (options) {
+                const int num = Engine::lowestDigit(options);
+                options &= options - 1;
+
+                State next = subtree;
+                Engine::place(next, cell, num, diagonal);
+                if (options) {
+                    spawn(next, depth + 1);
+                } else {
+                    run(next, depth + 1);
+                }
+            }
+        }
+
+        /**
+         * @brief Adds a task's batch of nodes and applies the budget and check
+         * @return True if the search must stop
+         */
+        bool interrupted(std::int64_t batch)
+        {
+            const std::int64_t total = nodes.fetch_add(batch) + batch;
+            if (total > maxNodes || (check && check(total))) {
+                stop.store(true);
+            }
+            return stop.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Records the first solution and stops every other task
+         */
+        void publish(const State &solved)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!found) {
+                found = true;
+                solution = solved;
+            }
+            stop.store(true);
+        }
+
+        void finishTask()
+        {
+            // Decrement under the lock: once the waiter sees zero it destroys
+            // this object, so nothing may touch it after the lock is released
+            std::lock_guard<std::mutex> lock(mutex);
+            if (outstanding.fetch_sub(1) == 1) {
+                done.notify_all();
+            }
+        }
+
+        /**
+         * @brief Blocks until every task of this search (not of the pool) is done
+         */
+        void waitForTasks()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [this] { return outstanding.load() == 0; });
+        }
+
+        const bool diagonal;
+        WorkStealingPool &pool;
+        const int splitDepth;
+        const std::int64_t maxNodes;
+        const InterruptCheck &check;
+
+        std::atomic<bool> stop;             ///< Solution found or limit hit
+        std::atomic<std::int64_t> nodes;    ///< Nodes flushed by all tasks
+        std::atomic<int> outstanding;       ///< Tasks spawned but not finished
+        std::mutex mutex;                   ///< Guards found/solution, pairs with done
+        std::condition_variable done;       ///< Signalled when outstanding drops to zero
+        bool found;
+        State solution;
+    };
+};
+
+#endif // PARALLELSEARCH_H
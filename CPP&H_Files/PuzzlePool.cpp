@@ -0,0 +1,181 @@
+/**
+ * @file PuzzlePool.cpp
+ * @brief Implementation of the PuzzlePool class
+ */
+
+#include "PuzzlePool.h"
+#include <QThread>
+#include <algorithm>
+#include <utility>
+
+/**
+ * Constructor for PuzzlePool
+ * The filler runs at the lowest priority so it only uses otherwise idle CPU
+ * and never competes with rendering
+ */
+PuzzlePool::PuzzlePool(Producer producer, int capacity)
+    : m_producer(std::move(producer)),
+      m_capacity(0),
+      m_epoch(0),
+      m_hits(0),
+      m_misses(0),
+      m_stopping(false),
+      m_thread(nullptr)
+{
+    resizeRings(std::max(0, capacity));
+    m_thread = QThread::create([this]() { fillLoop(); });
+    m_thread->start(QThread::LowestPriority);
+}
+
+/**
+ * Destructor for PuzzlePool
+ */
+PuzzlePool::~PuzzlePool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    m_thread->wait();
+    delete m_thread;
+}
+
+/**
+ * Pops the oldest puzzle of a difficulty
+ */
+bool PuzzlePool::take(int difficulty, Puzzle &puzzle)
+{
+    if (difficulty < 1 || difficulty > DIFFICULTY_COUNT) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Ring &ring = m_rings[difficulty - 1];
+        if (ring.count == 0) {
+            ++m_misses;
+            return false;
+        }
+        puzzle = std::move(ring.puzzles[ring.head]);
+        ring.head = (ring.head + 1) % m_capacity;
+        --ring.count;
+        ++m_hits;
+    }
+    m_wake.notify_one();
+    return true;
+}
+
+/**
+ * Swaps the producer and empties the rings; the epoch bump makes the
+ * filler discard whatever the old producer is still working on
+ */
+void PuzzlePool::reset(Producer producer)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_producer = std::move(producer);
+        ++m_epoch;
+        for (Ring &ring : m_rings) {
+            ring.head = 0;
+            ring.count = 0;
+        }
+    }
+    m_wake.notify_one();
+}
+
+/**
+ * Changes the ring capacity
+ */
+void PuzzlePool::setCapacity(int capacity)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        resizeRings(std::max(0, capacity));
+    }
+    m_wake.notify_one();
+}
+
+int PuzzlePool::capacity() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_capacity;
+}
+
+int PuzzlePool::available(int difficulty) const
+{
+    if (difficulty < 1 || difficulty > DIFFICULTY_COUNT) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_rings[difficulty - 1].count;
+}
+
+std::int64_t PuzzlePool::hits() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hits;
+}
+
+std::int64_t PuzzlePool::misses() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_misses;
+}
+
+/**
+ * Copies the live puzzles of each ring, oldest first, into new storage
+ */
+void PuzzlePool::resizeRings(int capacity)
+{
+    for (Ring &ring : m_rings) {
+        std::vector<Puzzle> puzzles(capacity);
+        const int keep = std::min(ring.count, capacity);
+        for (int i = 0; i < keep; ++i) {
+            puzzles[i] = std::move(ring.puzzles[(ring.head + i) % m_capacity]);
+        }
+        ring.puzzles = std::move(puzzles);
+        ring.head = 0;
+        ring.count = keep;
+    }
+    m_capacity = capacity;
+}
+
+/**
+ * Picks the ring with the fewest puzzles, produces one without holding the
+ * lock, and stores it unless the pool was reset or resized meanwhile
+ */
+void PuzzlePool::fillLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        int target = -1;
+        m_wake.wait(lock, [this, &target]() {
+            if (m_stopping) {
+                return true;
+            }
+            for (int i = 0; i < DIFFICULTY_COUNT; ++i) {
+                if (m_rings[i].count < m_capacity &&
+                    (target < 0 || m_rings[i].count < m_rings[target].count)) {
+                    target = i;
+                }
+            }
+            return target >= 0;
+        });
+        if (m_stopping) {
+            return;
+        }
+
+        const Producer producer = m_producer;
+        const std::uint64_t epoch = m_epoch;
+        lock.unlock();
+        Puzzle puzzle = producer(target + 1);
+        lock.lock();
+
+        Ring &ring = m_rings[target];
+        if (epoch == m_epoch && ring.count < m_capacity) {
+            ring.puzzles[(ring.head + ring.count) % m_capacity] = std::move(puzzle);
+            ++ring.count;
+        }
+    }
+}
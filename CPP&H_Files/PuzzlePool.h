@@ -0,0 +1,131 @@
+/**
+ * @file PuzzlePool.h
+ * @brief Header file for the PuzzlePool class, a background puzzle cache
+ *
+ * This class is responsible for:
+ * - Keeping a ring buffer of ready puzzles (with solutions) per difficulty
+ * - Topping the buffers up from a low-priority background thread
+ * - Counting how often a request was served from the buffer (hit) or not (miss)
+ */
+
+#ifndef PUZZLEPOOL_H
+#define PUZZLEPOOL_H
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+class QThread;
+
+/**
+ * @class PuzzlePool
+ * @brief Pre-generated puzzles for difficulties 1 to 3
+ *
+ * The pool does not know how to make puzzles; it calls a Producer on its
+ * worker thread, so the producer must be thread-safe and must not touch
+ * GUI objects. reset() swaps the producer (for example when the grid size
+ * changes) and drops everything made by the previous one, including a
+ * puzzle that is being produced at that moment.
+ */
+class PuzzlePool
+{
+public:
+    using Grid = std::vector<std::vector<int>>;
+
+    /** @brief One ready-to-play puzzle */
+    struct Puzzle {
+        Grid givens;
+        Grid solution;
+        int rating = 0;   ///< Hardest technique needed (SudokuGrader::Technique as int)
+        std::uint64_t seed = 0; ///< Rebuilds the puzzle via SudokuGenerator::generateSudoku
+        int digLimit = -1;      ///< Removal steps tried before the budget ran out; -1 if all were
+    };
+
+    /** @brief Makes one puzzle of the given difficulty (1 to 3) */
+    using Producer = std::function<Puzzle(int difficulty)>;
+
+    static constexpr int DIFFICULTY_COUNT = 3;
+
+    /**
+     * @brief Starts the background thread
+     * @param producer Puzzle factory, run on the background thread
+     * @param capacity Puzzles kept per difficulty (0 disables pre-generation)
+     */
+    PuzzlePool(Producer producer, int capacity);
+
+    /**
+     * @brief Stops the background thread; a puzzle in progress is finished first
+     */
+    ~PuzzlePool();
+
+    PuzzlePool(const PuzzlePool &) = delete;
+    PuzzlePool &operator=(const PuzzlePool &) = delete;
+
+    /**
+     * @brief Takes a ready puzzle in O(1) and wakes the background thread to
+     * replace it
+     * @param difficulty Difficulty level (1 to 3)
+     * @param puzzle Receives the puzzle on a hit
+     * @return False on a miss (buffer empty); the caller generates itself
+     */
+    bool take(int difficulty, Puzzle &puzzle);
+
+    /**
+     * @brief Replaces the producer and discards every buffered puzzle
+     * @param producer New puzzle factory
+     */
+    void reset(Producer producer);
+
+    /**
+     * @brief Changes how many puzzles are kept per difficulty
+     * @param capacity New size; existing puzzles beyond it are dropped
+     */
+    void setCapacity(int capacity);
+
+    /** @brief Puzzles kept per difficulty */
+    int capacity() const;
+
+    /** @brief Puzzles currently ready for a difficulty */
+    int available(int difficulty) const;
+
+    /** @brief Requests served from the buffer */
+    std::int64_t hits() const;
+
+    /** @brief Requests that found the buffer empty */
+    std::int64_t misses() const;
+
+private:
+    /** @brief Fixed-capacity ring of puzzles for one difficulty */
+    struct Ring {
+        std::vector<Puzzle> puzzles;
+        int head = 0;   ///< Oldest puzzle
+        int count = 0;
+    };
+
+    /**
+     * @brief Background loop: refill the emptiest ring, sleep when all are full
+     */
+    void fillLoop();
+
+    /**
+     * @brief Resizes every ring, keeping the oldest puzzles that still fit
+     * (caller holds m_mutex)
+     */
+    void resizeRings(int capacity);
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;          ///< Signalled on take, reset, resize and stop
+    std::array<Ring, DIFFICULTY_COUNT> m_rings;
+    Producer m_producer;
+    int m_capacity;
+    std::uint64_t m_epoch;                   ///< Bumped by reset; stale puzzles are dropped
+    std::int64_t m_hits;
+    std::int64_t m_misses;
+    bool m_stopping;
+    QThread *m_thread;
+};
+
+#endif // PUZZLEPOOL_H
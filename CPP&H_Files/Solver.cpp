@@ -1,7 +1,65 @@
 #include "Solver.h"
+#include "DlxSolver.h"
+#include "ParallelSearch.h"
+#include "WorkStealingPool.h"
 #include <QDebug>
+#include <QMetaMethod>
+#include <QMetaObject>
 #include <algorithm>
-#include <numeric>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+/**
+ * @brief Loads a validated-shape grid into an engine state
+ * @return False if two givens conflict
+ */
+template <int BoxSize>
+bool loadGrid(const Solver::Grid &grid, typename SudokuEngine<BoxSize>::State &state, bool checkDiagonal)
+{
+    using Engine = SudokuEngine<BoxSize>;
+    typename Engine::Cells cells{};
+    for (int r = 0; r < Engine::GRID_SIZE; ++r) {
+        for (int c = 0; c < Engine::GRID_SIZE; ++c) {
+            cells[r * Engine::GRID_SIZE + c] = static_cast<std::uint8_t>(grid[r][c]);
+        }
+    }
+    return Engine::load(cells, state, checkDiagonal);
+}
+
+/**
+ * @brief Loads a board of this box size into an engine state
+ * @return False if two givens conflict
+ */
+template <int BoxSize>
+bool loadBoard(const Board &board, typename SudokuEngine<BoxSize>::State &state, bool checkDiagonal)
+{
+    using Engine = SudokuEngine<BoxSize>;
+    typename Engine::Cells cells;
+    std::copy(board.cells(), board.cells() + Engine::CELL_COUNT, cells.begin());
+    return Engine::load(cells, state, checkDiagonal);
+}
+
+/**
+ * @brief Copies an engine state's cells back into a board
+ */
+template <int BoxSize>
+void storeBoard(const typename SudokuEngine<BoxSize>::State &state, Board &board)
+{
+    std::copy(state.cells.begin(), state.cells.end(), board.cells());
+}
+
+/**
+ * @brief Box side for a grid side length, 0 if it is not a supported square
+ */
+int boxSizeForSide(int side)
+{
+    const int box = static_cast<int>(std::lround(std::sqrt(static_cast<double>(side))));
+    return (box >= 2 && box <= 5 && box * box == side) ? box : 0;
+}
+
+} // namespace
 
 /**
  * @brief Constructor initializes solver with default parameters
@@ -9,10 +67,23 @@
  */
 Solver::Solver(QObject *parent)
     : QObject(parent), 
+      m_engine(Engine::Backtrack),
       m_maxIterations(1000000), 
-      m_currentIterations(0), 
-      m_checkDiagonal(false) {
-    // Reserve space for better performance
+      m_timeLimitMs(0),
+      m_boxSize(3),
+      m_checkDiagonal(false),
+      m_generation(0) {
+    // One worker solves, a second lets a new request start while a cancelled one unwinds
+    m_pool.setMaxThreadCount(2);
+}
+
+/**
+ * @brief Cancels any running solve and waits for the workers to finish
+ * so no task outlives the object it reports to
+ */
+Solver::~Solver() {
+    cancel();
+    m_pool.waitForDone();
 }
 
 /**
@@ -22,6 +93,24 @@ void Solver::setCheckDiagonal(bool enabled) {
     m_checkDiagonal = enabled;
 }
 
+/**
+ * @brief Select the grid size by box side
+ */
+void Solver::setBoxSize(int boxSize) {
+    if (boxSize >= 2 && boxSize <= 5) {
+        m_boxSize = boxSize;
+    } else {
+        qDebug() << "Unsupported box size:" << boxSize;
+    }
+}
+
+/**
+ * @brief Current box side
+ */
+int Solver::boxSize() const {
+    return m_boxSize;
+}
+
 /**
  * @brief Set maximum iterations to prevent runaway recursion
  */
@@ -29,240 +118,357 @@ void Solver::setMaxIterations(int maxIter) {
     m_maxIterations = maxIter > 0 ? maxIter : 1000000;
 }
 
+/**
+ * @brief Set the per-solve wall-clock deadline (0 disables it)
+ */
+void Solver::setTimeLimit(int milliseconds) {
+    m_timeLimitMs = milliseconds > 0 ? milliseconds : 0;
+}
+
+/**
+ * @brief Invalidate the current request; workers notice within CHECK_INTERVAL nodes
+ */
+void Solver::cancel() {
+    ++m_generation;
+}
+
+/**
+ * @brief Select the engine by name; the DLX matrix is built on first use
+ */
+void Solver::setEngine(const QString &engine) {
+    if (engine == QStringLiteral("dlx")) {
+        m_engine = Engine::Dlx;
+    } else if (engine == QStringLiteral("backtrack")) {
+        m_engine = Engine::Backtrack;
+    } else {
+        qDebug() << "Unknown solver engine:" << engine;
+    }
+}
+
+/**
+ * @brief Name of the active engine
+ */
+QString Solver::engine() const {
+    return m_engine == Engine::Dlx ? QStringLiteral("dlx") : QStringLiteral("backtrack");
+}
+
+/**
+ * @brief Sets the thread count of one backtracking solve
+ * A running solve keeps the pool it started with; the new size applies to
+ * the next request
+ */
+void Solver::setSearchThreads(int threads) {
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    if (threads == searchThreads()) {
+        return;
+    }
+    m_searchPool = threads > 1 ? std::make_shared<WorkStealingPool>(threads) : nullptr;
+}
+
+/**
+ * @brief Threads used by one backtracking solve
+ */
+int Solver::searchThreads() const {
+    return m_searchPool ? m_searchPool->threadCount() : 1;
+}
+
 /**
  * @brief Main entry point for solving Sudoku puzzles from QML
- * Converts QML grid format, validates input, solves, and emits result
+ * Converts and validates the grid on the calling thread, then hands the
+ * search to a worker; the result comes back through boardSolved
  */
 void Solver::solvePuzzle(QVariantList qmlGrid) {
-    // Reset iteration counter for new solve attempt
-    m_currentIterations = 0;
-    
-    // Input validation
-    if (qmlGrid.size() != GRID_SIZE) {
-        qDebug() << "Invalid grid size:" << qmlGrid.size() << "expected" << GRID_SIZE;
-        emit sudokuSolved(false, QVariantList());
+    // Convert QML grid to internal format with validation
+    Grid grid;
+    if (!parseGrid(qmlGrid, m_boxSize * m_boxSize, grid)) {
+        startSolve(Board(), nullptr); // Rejected there
+        return;
+    }
+    startSolve(Board::fromGrid(grid), nullptr);
+}
+
+/**
+ * @brief Solves a board as is; its cells are shared with the worker, not copied
+ */
+void Solver::solvePuzzle(const Board &board) {
+    startSolve(board, nullptr);
+}
+
+/**
+ * @brief Solves straight from the model's cells; no QVariant conversion in
+ * either direction
+ */
+void Solver::solveBoard(BoardModel *board) {
+    startSolve(board ? board->board() : Board(), board);
+}
+
+void Solver::startSolve(const Board &puzzle, BoardModel *board) {
+    // A new request supersedes whatever is still running
+    const quint64 generation = ++m_generation;
+    if (puzzle.boxSize() != m_boxSize) {
+        qDebug() << "Invalid grid: box size" << puzzle.boxSize() << "expected" << m_boxSize;
+        reportSolved(false, Board());
         return;
     }
+
+    // Validate the givens for conflicts before bothering a worker
+    bool valid = false;
+    const bool checkDiagonal = m_checkDiagonal;
+    dispatchBoxSize(m_boxSize, [&](auto box) {
+        typename SudokuEngine<decltype(box)::value>::State state;
+        valid = loadBoard<decltype(box)::value>(puzzle, state, checkDiagonal);
+    });
+    if (!valid) {
+        qDebug() << "Initial grid contains conflicts - unsolvable";
+        reportSolved(false, Board());
+        return;
+    }
+
+    // Snapshot the configuration for the worker
+    SolveContext context;
+    context.checkDiagonal = m_checkDiagonal;
+    context.boxSize = m_boxSize;
+    context.owner = this;
+    context.searchPool = m_searchPool;
+    context.generation = generation;
+    context.board = board;
+    if (m_timeLimitMs > 0) {
+        context.maxIterations = std::numeric_limits<qint64>::max();
+        context.deadline = QDeadlineTimer(m_timeLimitMs);
+    } else {
+        context.maxIterations = m_maxIterations;
+        context.deadline = QDeadlineTimer(QDeadlineTimer::Forever);
+    }
+
+    Engine engine = m_engine;
+    if (engine == Engine::Dlx && m_boxSize != 3) {
+        qDebug() << "DLX engine supports 9x9 only, using backtracking";
+        engine = Engine::Backtrack;
+    }
+    m_pool.start([this, puzzle, engine, context]() {
+        runSolve(puzzle, engine, context);
+    });
+}
+
+/**
+ * @brief The list form is built only for receivers that still take it
+ */
+void Solver::reportSolved(bool solvable, const Board &solution) {
+    emit boardSolved(solvable, solution);
+    if (isSignalConnected(QMetaMethod::fromSignal(&Solver::sudokuSolved))) {
+        emit sudokuSolved(solvable, solvable ? solution.toVariantList() : QVariantList());
+    }
+}
+
+/**
+ * @brief Converts the QML grid, rejecting bad shapes and out-of-range values
+ */
+bool Solver::parseGrid(const QVariantList &qmlGrid, int size, Grid &grid) {
+    // Input validation
+    if (qmlGrid.size() != size) {
+        qDebug() << "Invalid grid size:" << qmlGrid.size() << "expected" << size;
+        return false;
+    }
     
-    // Convert QML grid to internal format with validation
-    Grid grid(GRID_SIZE, std::vector<int>(GRID_SIZE));
-    for (int i = 0; i < GRID_SIZE; ++i) {
+    grid.assign(size, std::vector<int>(size));
+    for (int i = 0; i < size; ++i) {
         QVariantList row = qmlGrid[i].toList();
-        if (row.size() != GRID_SIZE) {
+        if (row.size() != size) {
             qDebug() << "Invalid row size at row" << i << ":" << row.size();
-            emit sudokuSolved(false, QVariantList());
-            return;
+            return false;
         }
         
-        for (int j = 0; j < GRID_SIZE; ++j) {
+        for (int j = 0; j < size; ++j) {
             int value = row[j].toInt();
             // Validate cell values are in valid range
-            if (value < 0 || value > MAX_NUM) {
+            if (value < 0 || value > size) {
                 qDebug() << "Invalid cell value at (" << i << "," << j << "):" << value;
-                emit sudokuSolved(false, QVariantList());
-                return;
+                return false;
             }
             grid[i][j] = value;
         }
     }
+    return true;
+}
 
-    // Validate initial grid state for conflicts
-    if (!isInitialGridValid(grid)) {
-        qDebug() << "Initial grid contains conflicts - unsolvable";
-        emit sudokuSolved(false, QVariantList());
-        return;
+/**
+ * @brief QML entry point for solution counting (synchronous)
+ */
+int Solver::countSolutions(QVariantList qmlGrid, int limit) const {
+    Grid grid;
+    if (!parseGrid(qmlGrid, m_boxSize * m_boxSize, grid)) {
+        return 0;
     }
+    return countSolutions(grid, limit, m_checkDiagonal);
+}
 
-    // Create working copy and attempt to solve
-    Grid solved = grid;
-    bool solvable = solveSudoku(solved);
-
-    // Convert solution back to QML format
-    QVariantList qmlSolution;
-    if (solvable) {
-        qmlSolution.reserve(GRID_SIZE);
-        for (const auto &row : solved) {
-            QVariantList qmlRow;
-            qmlRow.reserve(GRID_SIZE);
-            for (int cell : row) {
-                qmlRow.append(cell);
-            }
-            qmlSolution.append(QVariant(qmlRow));
-        }
-        qDebug() << "Puzzle solved in" << m_currentIterations << "iterations";
-    } else {
-        qDebug() << "Puzzle unsolvable after" << m_currentIterations << "iterations";
+/**
+ * @brief Validates the givens, then counts with early exit at the limit
+ */
+int Solver::countSolutions(const Grid &grid, int limit, bool checkDiagonal, qint64 maxNodes) {
+    int count = 0;
+    if (limit <= 0) {
+        return count;
     }
 
-    emit sudokuSolved(solvable, qmlSolution);
+    dispatchBoxSize(boxSizeForSide(static_cast<int>(grid.size())), [&](auto box) {
+        using E = SudokuEngine<decltype(box)::value>;
+        typename E::State state;
+        if (loadGrid<decltype(box)::value>(grid, state, checkDiagonal)) {
+            count = E::countSolutions(state, limit, checkDiagonal, maxNodes);
+        }
+    });
+    return count;
 }
 
 /**
- * @brief Optimized recursive backtracking solver with smart cell selection
- * Uses most constrained variable heuristic for better performance
+ * @brief Headless 9x9 solve on the calling thread with the propagation engine
+ * Safe to call concurrently: all search state lives on the caller's stack
  */
-bool Solver::solveSudoku(Grid &grid) {
-    // Check iteration limit to prevent infinite recursion
-    if (m_currentIterations++ > m_maxIterations) {
-        qDebug() << "Maximum iterations reached:" << m_maxIterations;
-        return false;
+bool Solver::solveCells(Cells &cells, bool checkDiagonal, qint64 maxIterations, qint64 *nodes) {
+    using E = SudokuEngine<3>;
+    E::State state;
+    if (!E::load(cells, state, checkDiagonal)) {
+        return false; // Out of range or conflicting given
     }
 
-    // Find next empty cell using optimized strategy
-    int row, col;
-    if (!findEmptyCell(grid, row, col)) {
-        return true; // No empty cells - puzzle solved!
-    }
+    SolveContext context;
+    context.checkDiagonal = checkDiagonal;
+    context.maxIterations = maxIterations;
+    context.deadline = QDeadlineTimer(QDeadlineTimer::Forever);
 
-    // Get valid numbers for this position (constraint propagation)
-    std::vector<int> validNums = getValidNumbers(grid, row, col);
-    
-    // Try each valid number (already filtered for efficiency)
-    for (int num : validNums) {
-        grid[row][col] = num;
-        
-        // Recursive call - if this path leads to solution, we're done
-        if (solveSudoku(grid)) {
-            return true;
-        }
-        
-        // Backtrack: undo the move and try next number
-        grid[row][col] = 0;
+    const bool solved = E::solve(state, checkDiagonal, [&context](int depth) {
+        context.depth = depth;
+        return interrupted(context);
+    });
+    if (solved) {
+        cells = state.cells;
     }
-    
-    // No valid number worked - backtrack to previous level
-    return false;
+    if (nodes) {
+        *nodes = context.iterations;
+    }
+    return solved;
 }
 
 /**
- * @brief Optimized constraint validation with early termination
- * Checks row, column, 3x3 box, and optional diagonal constraints
+ * @brief Runs one solve on a worker thread
+ * The result is posted back to the Solver's thread and dropped there if a
+ * newer request has been made in the meantime
  */
-bool Solver::isValid(const Grid &grid, int row, int col, int num) const {
-    // Check row and column simultaneously for better cache performance
-    for (int x = 0; x < GRID_SIZE; ++x) {
-        if (grid[row][x] == num || grid[x][col] == num) {
-            return false;
-        }
-    }
+void Solver::runSolve(Board board, Engine engine, SolveContext context) {
+    context.sinceProgress.start();
 
-    // Check 3x3 box with optimized bounds calculation
-    const int boxStartRow = (row / BOX_SIZE) * BOX_SIZE;
-    const int boxStartCol = (col / BOX_SIZE) * BOX_SIZE;
-    
-    for (int i = 0; i < BOX_SIZE; ++i) {
-        for (int j = 0; j < BOX_SIZE; ++j) {
-            if (grid[boxStartRow + i][boxStartCol + j] == num) {
-                return false;
-            }
-        }
-    }
+    // Solve with the selected engine; both leave the solution in board
+    bool solvable = false;
+    if (engine == Engine::Dlx) {
+        Cells cells;
+        std::copy(board.cells(), board.cells() + board.cellCount(), cells.begin());
 
-    // Check diagonal constraints if enabled (X-Sudoku variant)
-    if (m_checkDiagonal) {
-        // Main diagonal (top-left to bottom-right)
-        if (row == col) {
-            for (int i = 0; i < GRID_SIZE; ++i) {
-                if (grid[i][i] == num) {
-                    return false;
-                }
-            }
+        std::lock_guard<std::mutex> lock(m_dlxMutex);
+        // The matrix shape depends on the diagonal flag, rebuild only when it changes
+        if (!m_dlx || m_dlx->diagonal() != context.checkDiagonal) {
+            m_dlx = std::make_unique<DlxSolver>(context.checkDiagonal);
         }
-        
-        // Anti-diagonal (top-right to bottom-left)
-        if (row + col == GRID_SIZE - 1) {
-            for (int i = 0; i < GRID_SIZE; ++i) {
-                if (grid[i][GRID_SIZE - 1 - i] == num) {
-                    return false;
-                }
-            }
+        qint64 nodes = 0;
+        solvable = m_dlx->solve(cells, cells, context.maxIterations, nodes,
+                                [&context](qint64 visited) {
+                                    context.iterations = visited;
+                                    return checkpoint(context);
+                                });
+        context.iterations = nodes;
+        if (solvable) {
+            std::copy(cells.begin(), cells.end(), board.cells());
         }
+    } else {
+        dispatchBoxSize(context.boxSize, [&](auto box) {
+            using E = SudokuEngine<decltype(box)::value>;
+            typename E::State state;
+            loadBoard<decltype(box)::value>(board, state, context.checkDiagonal);
+            if (context.searchPool) {
+                // Tasks report concurrently; checkpoint touches the context, so serialize it
+                std::mutex contextMutex;
+                qint64 nodes = 0;
+                solvable = ParallelSearch<decltype(box)::value>::solve(
+                    state, context.checkDiagonal, *context.searchPool,
+                    ParallelSearch<decltype(box)::value>::defaultSplitDepth(context.searchPool->threadCount()),
+                    context.maxIterations, nodes,
+                    [&context, &contextMutex](qint64 total) {
+                        std::lock_guard<std::mutex> lock(contextMutex);
+                        context.iterations = total;
+                        return checkpoint(context);
+                    });
+                context.iterations = nodes;
+            } else {
+                solvable = E::solve(state, context.checkDiagonal, [&context](int depth) {
+                    context.depth = depth;
+                    return interrupted(context);
+                });
+            }
+            if (solvable) {
+                storeBoard<decltype(box)::value>(state, board);
+            }
+        });
     }
 
-    return true;
-}
+    if (context.generation != m_generation.load()) {
+        return; // Cancelled or superseded, nobody wants this result
+    }
 
-/**
- * @brief Validates initial puzzle state for rule violations
- * Temporarily removes each filled cell to check if its value is valid
- */
-bool Solver::isInitialGridValid(const Grid &grid) {
-    // Create a mutable copy for validation
-    Grid tempGrid = grid;
-    
-    for (int row = 0; row < GRID_SIZE; ++row) {
-        for (int col = 0; col < GRID_SIZE; ++col) {
-            int val = tempGrid[row][col];
-            if (val != 0) {
-                // Temporarily remove the value to test validity
-                tempGrid[row][col] = 0;
-                if (!isValid(tempGrid, row, col, val)) {
-                    return false; // Conflict found
-                }
-                // Restore the value
-                tempGrid[row][col] = val;
+    if (solvable) {
+        qDebug() << "Puzzle solved in" << context.iterations << "iterations";
+    } else {
+        qDebug() << "Puzzle unsolvable after" << context.iterations << "iterations";
+    }
+
+    const quint64 generation = context.generation;
+    const QPointer<BoardModel> target = context.board;
+    const Board solution = solvable ? board : Board();
+    QMetaObject::invokeMethod(this, [this, generation, solvable, solution, target]() {
+        if (generation == m_generation.load()) {
+            if (solvable && target) {
+                target->fillSolution(solution);
             }
+            reportSolved(solvable, solution);
         }
-    }
-    return true;
+    }, Qt::QueuedConnection);
 }
 
 /**
- * @brief Find next empty cell using most constrained variable heuristic
- * Selects the empty cell with fewest possible values for better pruning
+ * @brief Counts a node against the cap; every CHECK_INTERVAL nodes also
+ * runs the more expensive checkpoint
  */
-bool Solver::findEmptyCell(const Grid &grid, int &row, int &col) const {
-    int minOptions = MAX_NUM + 1;
-    bool found = false;
-    
-    for (int r = 0; r < GRID_SIZE; ++r) {
-        for (int c = 0; c < GRID_SIZE; ++c) {
-            if (grid[r][c] == 0) {
-                // Count valid options for this cell
-                int options = 0;
-                for (int num = MIN_NUM; num <= MAX_NUM; ++num) {
-                    if (isValid(grid, r, c, num)) {
-                        options++;
-                    }
-                }
-                
-                // If no valid options, this path is impossible
-                if (options == 0) {
-                    return false;
-                }
-                
-                // Select cell with minimum options (most constrained)
-                if (options < minOptions) {
-                    minOptions = options;
-                    row = r;
-                    col = c;
-                    found = true;
-                    
-                    // If only one option, this is optimal
-                    if (options == 1) {
-                        return true;
-                    }
-                }
-            }
+bool Solver::interrupted(SolveContext &context) {
+    if (context.iterations++ > context.maxIterations) {
+        if (context.owner) {
+            qDebug() << "Maximum iterations reached:" << context.maxIterations;
         }
+        return true;
     }
-    
-    return found;
+    return context.iterations % CHECK_INTERVAL == 0 && checkpoint(context);
 }
 
 /**
- * @brief Get all valid numbers for a specific cell position
- * Pre-filters valid options to reduce backtracking iterations
+ * @brief Stops stale or overdue solves and emits progress at most every
+ * PROGRESS_INTERVAL_MS; signals emitted here are queued to the GUI thread
  */
-std::vector<int> Solver::getValidNumbers(const Grid &grid, int row, int col) const {
-    std::vector<int> validNums;
-    validNums.reserve(MAX_NUM); // Reserve space for efficiency
-    
-    for (int num = MIN_NUM; num <= MAX_NUM; ++num) {
-        if (isValid(grid, row, col, num)) {
-            validNums.push_back(num);
+bool Solver::checkpoint(SolveContext &context) {
+    if (context.deadline.hasExpired()) {
+        if (context.owner) {
+            qDebug() << "Solve deadline expired after" << context.iterations << "iterations";
         }
+        return true;
     }
-    
-    return validNums;
+    if (!context.owner) {
+        return false; // Headless solve: no cancellation or progress reporting
+    }
+    if (context.generation != context.owner->m_generation.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    if (context.sinceProgress.elapsed() >= PROGRESS_INTERVAL_MS) {
+        context.sinceProgress.restart();
+        emit context.owner->solveProgress(context.iterations, context.depth);
+    }
+    return false;
 }
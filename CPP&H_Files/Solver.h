@@ -3,38 +3,94 @@
 
 #include <QObject>
 #include <QVariantList>
+#include <QString>
+#include <QThreadPool>
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <memory>
 #include <vector>
 #include <array>
-#include <bitset>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include "Board.h"
+#include "BoardModel.h"
+#include "SudokuEngine.h"
+
+class DlxSolver;
+class WorkStealingPool;
 
 /**
  * @brief High-performance Sudoku solver with backtracking algorithm
  * 
  * This class provides an efficient Sudoku solving implementation with support
- * for standard 9x9 grids and optional diagonal constraints. Uses optimized
- * constraint checking and early termination for maximum performance.
+ * for 4x4, 9x9 (default), 16x16 and 25x25 grids and optional diagonal
+ * constraints. It is a thin QML adapter over SudokuEngine, which keeps the
+ * board as a flat cell array plus per-cell candidate bitmasks and runs
+ * singles/locked-candidate propagation at every node, so most puzzles are
+ * solved with little or no guessing and contradictions surface immediately.
+ *
+ * Solving runs on a private worker pool: solvePuzzle returns immediately, a
+ * newer request cancels the one in flight, and the result is delivered through
+ * boardSolved (and sudokuSolved) on the thread that owns the Solver (the GUI thread).
  */
 class Solver : public QObject {
     Q_OBJECT
 
 public:
     explicit Solver(QObject *parent = nullptr);
+    ~Solver() override;
     
     // Type aliases for better code readability
     using Grid = std::vector<std::vector<int>>;
-    using BitSet = std::bitset<10>; // Index 0 unused, 1-9 for digits
+    using Cells = SudokuEngine<3>::Cells; // Flat row-major 9x9 board, 0 = empty
     
     /**
-     * @brief Solves a Sudoku puzzle from QML interface
-     * @param qmlGrid 9x9 grid as QVariantList where 0 represents empty cells
+     * @brief Solves a Sudoku puzzle from QML interface asynchronously
+     * @param qmlGrid Square grid (boxSize² per side) as QVariantList where 0
+     *        represents empty cells
+     *
+     * Any solve still in flight is cancelled; its result is never emitted.
      */
     Q_INVOKABLE void solvePuzzle(QVariantList qmlGrid);
+
+    /**
+     * @brief Solves a Board asynchronously
+     * @param board Puzzle; its box size must be boxSize()
+     *
+     * The same as the QVariantList form without converting the grid; the
+     * solve works on the board's shared cells.
+     */
+    Q_INVOKABLE void solvePuzzle(const Board &board);
+
+    /**
+     * @brief Solves the board of a BoardModel asynchronously
+     * @param board Board to solve; its box size must match boxSize()
+     *
+     * Like solvePuzzle, but the solution is also written into the board's
+     * empty cells (flagged correct) just before the result is signalled.
+     * If the board is destroyed first, the result is only signalled.
+     */
+    Q_INVOKABLE void solveBoard(BoardModel *board);
     
     /**
      * @brief Enable/disable diagonal constraint checking (X-Sudoku variant)
      * @param enabled True to check main diagonals for uniqueness
      */
     Q_INVOKABLE void setCheckDiagonal(bool enabled);
+
+    /**
+     * @brief Select the grid size
+     * @param boxSize Side of one box: 2 (4x4), 3 (9x9), 4 (16x16) or 5 (25x25);
+     *        other values are ignored
+     */
+    Q_INVOKABLE void setBoxSize(int boxSize);
+
+    /**
+     * @brief Current box side (3 for classic 9x9)
+     */
+    Q_INVOKABLE int boxSize() const;
     
     /**
      * @brief Set maximum iterations to prevent infinite loops
@@ -42,67 +98,197 @@ public:
      */
     Q_INVOKABLE void setMaxIterations(int maxIter);
 
+    /**
+     * @brief Set a wall-clock deadline for each solve
+     * @param milliseconds Time allowed per solve; when positive it replaces
+     *        the iteration cap, 0 or less restores the iteration cap
+     */
+    Q_INVOKABLE void setTimeLimit(int milliseconds);
+
+    /**
+     * @brief Cancel the solve in flight, if any; no result will be emitted for it
+     */
+    Q_INVOKABLE void cancel();
+
+    /**
+     * @brief Select the solving engine used by solvePuzzle
+     * @param engine "backtrack" (propagation + MRV, the default) or "dlx"
+     *        (Dancing Links exact cover, 9x9 only); unknown names are ignored
+     */
+    Q_INVOKABLE void setEngine(const QString &engine);
+
+    /**
+     * @brief Name of the engine currently in use
+     * @return "backtrack" or "dlx"
+     */
+    Q_INVOKABLE QString engine() const;
+
+    /**
+     * @brief Number of threads one backtracking solve may use
+     * @param threads 1 (the default) searches on a single worker; more splits
+     *        the top of the search tree across a work-stealing pool of that
+     *        size, 0 or less uses every core
+     *
+     * Worth it for hard or contradictory puzzles, where a single thread
+     * can spend seconds in one subtree; easy puzzles finish before the split
+     * pays off. The node cap applies to all threads together.
+     */
+    Q_INVOKABLE void setSearchThreads(int threads);
+
+    /**
+     * @brief Threads used by one backtracking solve
+     */
+    Q_INVOKABLE int searchThreads() const;
+
+    /**
+     * @brief Counts solutions of a puzzle, stopping early at a limit
+     * @param qmlGrid Square grid (boxSize² per side) where 0 represents empty cells
+     * @param limit Stop counting once this many solutions are found
+     * @return Number of solutions found, capped at limit (0 if invalid); limit
+     *         is also reported if the search budget runs out
+     *
+     * Runs synchronously; with the default limit of 2 it answers "is this
+     * puzzle unique?" in well under a millisecond for typical puzzles.
+     */
+    Q_INVOKABLE int countSolutions(QVariantList qmlGrid, int limit = 2) const;
+
+    /**
+     * @brief C++ entry point for solution counting, shared with SudokuGenerator
+     * @param grid Square grid of side 4, 9, 16 or 25 where 0 represents empty cells
+     * @param limit Stop counting once this many solutions are found
+     * @param checkDiagonal Whether the diagonals must also hold distinct digits
+     * @param maxNodes Search budget; when exhausted limit is returned
+     * @return Number of solutions found, capped at limit (0 if the givens
+     *         conflict or the size is unsupported)
+     */
+    static int countSolutions(const Grid &grid, int limit, bool checkDiagonal = false,
+                              qint64 maxNodes = 1000000);
+
+    /**
+     * @brief Synchronous, thread-safe solve for headless callers
+     * @param cells Puzzle to solve; receives the solution on success
+     * @param checkDiagonal Whether the diagonals must also hold distinct digits
+     * @param maxIterations Search nodes allowed before giving up
+     * @param nodes Optional output: search nodes visited
+     * @return True if solved; false if the givens conflict, the puzzle has
+     *         no solution or the node budget ran out
+     */
+    static bool solveCells(Cells &cells, bool checkDiagonal = false,
+                           qint64 maxIterations = 1000000, qint64 *nodes = nullptr);
+
 signals:
     /**
      * @brief Emitted when solving is complete
      * @param solvable True if puzzle has a valid solution
-     * @param solution Complete 9x9 grid solution (empty if unsolvable)
+     * @param solution Complete grid solution (invalid if unsolvable)
+     */
+    void boardSolved(bool solvable, const Board &solution);
+
+    /**
+     * @brief boardSolved as QVariantList rows; the list is only built while
+     * something is connected
+     * @param solvable True if puzzle has a valid solution
+     * @param solution Complete grid solution (empty if unsolvable)
      */
     void sudokuSolved(bool solvable, QVariantList solution);
 
+    /**
+     * @brief Periodic progress report while a solve is running (at most ~10/s)
+     * @param nodes Search nodes visited so far
+     * @param depth Current branching depth
+     */
+    void solveProgress(qint64 nodes, int depth);
+
 private:
+    /** @brief Available solving engines */
+    enum class Engine {
+        Backtrack, ///< Propagation plus MRV backtracking
+        Dlx        ///< Algorithm X on Dancing Links
+    };
+
     /**
-     * @brief Core recursive backtracking solver with optimizations
-     * @param grid Reference to the puzzle grid (modified in-place)
-     * @return True if puzzle is solvable, false otherwise
+     * @brief Per-solve configuration snapshot and counters
+     *
+     * Everything the worker needs is copied in here when the request is made,
+     * so the search never reads Solver members that the GUI thread may change.
      */
-    bool solveSudoku(Grid &grid);
-    
+    struct SolveContext {
+        bool checkDiagonal = false;
+        int boxSize = 3;
+        qint64 maxIterations = 0;     ///< Node cap, used when there is no deadline
+        QDeadlineTimer deadline;      ///< Wall-clock limit (Forever when unset)
+        Solver *owner = nullptr;      ///< Receives progress; null for headless solves
+        std::shared_ptr<WorkStealingPool> searchPool; ///< Set for a parallel search
+        quint64 generation = 0;       ///< Request id, stale once m_generation moves on
+        qint64 iterations = 0;        ///< Nodes visited so far
+        int depth = 0;                ///< Current branching depth
+        QElapsedTimer sinceProgress;  ///< Throttles solveProgress
+        QPointer<BoardModel> board;   ///< Receives the solution; dereferenced on the GUI thread only
+    };
+
     /**
-     * @brief Optimized constraint validation using bitsets
-     * @param grid Current puzzle state
-     * @param row Target row (0-8)
-     * @param col Target column (0-8)  
-     * @param num Number to validate (1-9)
-     * @return True if placement is valid according to Sudoku rules
+     * @brief Validates a request and hands it to a worker
+     * @param puzzle Puzzle; a box size other than boxSize() is rejected
+     * @param board Board to fill with the solution, or null
      */
-    bool isValid(const Grid &grid, int row, int col, int num) const;
-    
+    void startSolve(const Board &puzzle, BoardModel *board);
+
     /**
-     * @brief Validates initial puzzle state for conflicts
-     * @param grid Initial puzzle grid
-     * @return True if initial state is valid, false if conflicts exist
+     * @brief Emits boardSolved, and sudokuSolved when it has receivers
+     * @param solvable Whether a solution was found
+     * @param solution The solution, or an invalid board
      */
-    bool isInitialGridValid(const Grid &grid);
-    
+    void reportSolved(bool solvable, const Board &solution);
+
     /**
-     * @brief Find next empty cell using optimized search strategy
-     * @param grid Current puzzle state
-     * @param row Reference to store found row
-     * @param col Reference to store found column
-     * @return True if empty cell found, false if grid is complete
+     * @brief Node accounting: enforces the budget and reports progress
+     * @param context Limits and counters for this solve
+     * @return True when the solve must stop (cancelled, deadline, or cap)
      */
-    bool findEmptyCell(const Grid &grid, int &row, int &col) const;
-    
+    static bool interrupted(SolveContext &context);
+
+    /**
+     * @brief Periodic check: cancellation, deadline and throttled progress
+     * @param context Limits and counters for this solve
+     * @return True when the solve must stop
+     */
+    static bool checkpoint(SolveContext &context);
+
+    /**
+     * @brief Worker body: runs the selected engine and posts the result back
+     * @param board Validated puzzle
+     * @param engine Engine to use
+     * @param context Limits for this solve
+     */
+    void runSolve(Board board, Engine engine, SolveContext context);
+
     /**
-     * @brief Get valid numbers for a specific cell position
-     * @param grid Current puzzle state
-     * @param row Target row
-     * @param col Target column
-     * @return Vector of valid numbers (1-9) for the position
+     * @brief Converts and range-checks a QML grid
+     * @param qmlGrid Square grid as QVariantList
+     * @param size Expected side length
+     * @param grid Receives the converted grid
+     * @return False if the shape or any value is invalid
      */
-    std::vector<int> getValidNumbers(const Grid &grid, int row, int col) const;
+    static bool parseGrid(const QVariantList &qmlGrid, int size, Grid &grid);
+
+    /** @brief Nodes between cancellation/deadline/progress checks */
+    static constexpr int CHECK_INTERVAL = 1024;
+    /** @brief Minimum time between two solveProgress signals */
+    static constexpr int PROGRESS_INTERVAL_MS = 100;
 
-    // Configuration and state tracking
+    // Configuration and state tracking (GUI thread only)
+    Engine m_engine;            ///< Engine used by solvePuzzle
     int m_maxIterations;        ///< Maximum recursive calls allowed
-    mutable int m_currentIterations; ///< Current iteration count
+    int m_timeLimitMs;          ///< Per-solve deadline, 0 when unset
+    int m_boxSize;              ///< Box side; the grid is m_boxSize² wide
     bool m_checkDiagonal;       ///< Enable diagonal constraint checking
-    
-    // Performance optimization constants
-    static constexpr int GRID_SIZE = 9;
-    static constexpr int BOX_SIZE = 3;
-    static constexpr int MIN_NUM = 1;
-    static constexpr int MAX_NUM = 9;
+    std::shared_ptr<WorkStealingPool> m_searchPool; ///< Parallel search workers, null when sequential
+
+    // Worker side
+    std::unique_ptr<DlxSolver> m_dlx; ///< Lazily built, reused exact-cover matrix
+    std::mutex m_dlxMutex;      ///< Serializes a cancelled and a new DLX solve
+    std::atomic<quint64> m_generation; ///< Id of the latest request
+    QThreadPool m_pool;         ///< Workers running the searches
 };
 
 #endif // SOLVER_H
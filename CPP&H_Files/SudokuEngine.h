@@ -0,0 +1,568 @@
+/**
+ * @file SudokuEngine.h
+ * @brief Header-only Sudoku engine templated on the box size
+ *
+ * This header is responsible for:
+ * - Compile-time unit, peer and cell tables for 4x4, 9x9, 16x16 and 25x25 grids
+ * - The bitmask search state shared by Solver and SudokuGenerator
+ * - Constraint propagation, solving, solution counting and random filling
+ */
+
+#ifndef SUDOKUENGINE_H
+#define SUDOKUENGINE_H
+
+#include <QtAlgorithms>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <type_traits>
+
+/**
+ * @class SudokuEngine
+ * @brief Propagation + MRV search over candidate bitmasks for an N²xN² grid
+ *
+ * BoxSize is the side of one box (3 for classic Sudoku), so the grid has
+ * BoxSize² rows, columns, boxes and digits. Every table the search needs is
+ * generated with constexpr functions, so each instantiation gets loops with
+ * constant trip counts and no runtime setup. The class is stateless; all
+ * functions are static and operate on a caller-owned State, which makes the
+ * engine safe to use from any number of threads.
+ *
+ * Cells are stored row-major (index = row * SIZE + col). Each empty cell
+ * carries the mask of digits still possible there (bit d-1 for digit d);
+ * filled cells have an empty mask. Placing a digit clears it from every
+ * peer and logical eliminations only ever remove bits, so the state is a
+ * value type that the search copies on each branch.
+ */
+template <int BoxSize>
+class SudokuEngine
+{
+    static_assert(BoxSize >= 2 && BoxSize <= 5, "Supported box sizes are 2 to 5");
+
+public:
+    static constexpr int BOX_SIZE = BoxSize;
+    static constexpr int GRID_SIZE = BoxSize * BoxSize;
+    static constexpr int CELL_COUNT = GRID_SIZE * GRID_SIZE;
+    static constexpr int UNIT_COUNT = 3 * GRID_SIZE; ///< Rows, columns and boxes
+    static constexpr int DIAGONAL_UNIT_COUNT = UNIT_COUNT + 2; ///< Plus both diagonals
+    static constexpr int PEER_COUNT = 3 * GRID_SIZE - 2 * BoxSize - 1;
+
+    /** @brief Candidate mask wide enough for GRID_SIZE digits */
+    using Mask = std::conditional_t<(GRID_SIZE <= 16), std::uint16_t, std::uint32_t>;
+    /** @brief Flat row-major board, 0 for empty cells */
+    using Cells = std::array<std::uint8_t, CELL_COUNT>;
+
+    static constexpr Mask ALL_DIGITS = static_cast<Mask>((std::uint32_t(1) << GRID_SIZE) - 1);
+
+    /** @brief Board values plus per-cell candidate masks */
+    struct State {
+        Cells cells{};
+        std::array<Mask, CELL_COUNT> candidates{};
+        int emptyCount = CELL_COUNT;
+    };
+
+    /** @brief Unit membership of a single cell */
+    struct CellUnits {
+        std::uint8_t row;
+        std::uint8_t col;
+        std::uint8_t box;
+        bool onMainDiagonal;
+        bool onAntiDiagonal;
+    };
+
+    /**
+     * @brief Compile-time lookup tables
+     *
+     * Units are numbered rows 0..S-1, columns S..2S-1, boxes 2S..3S-1,
+     * main diagonal 3S and anti-diagonal 3S+1 (S = GRID_SIZE).
+     */
+    struct Tables {
+        std::array<CellUnits, CELL_COUNT> cellUnits{};
+        std::array<std::array<std::uint16_t, GRID_SIZE>, DIAGONAL_UNIT_COUNT> units{};
+        std::array<std::array<std::uint16_t, PEER_COUNT>, CELL_COUNT> peers{};
+    };
+
+    static constexpr int MAIN_DIAGONAL_UNIT = UNIT_COUNT;
+    static constexpr int ANTI_DIAGONAL_UNIT = UNIT_COUNT + 1;
+
+    static constexpr Tables makeTables()
+    {
+        Tables t{};
+        for (int i = 0; i < CELL_COUNT; ++i) {
+            const int r = i / GRID_SIZE;
+            const int c = i % GRID_SIZE;
+            t.cellUnits[i] = CellUnits{static_cast<std::uint8_t>(r),
+                                       static_cast<std::uint8_t>(c),
+                                       static_cast<std::uint8_t>((r / BoxSize) * BoxSize + c / BoxSize),
+                                       r == c,
+                                       r + c == GRID_SIZE - 1};
+        }
+        for (int i = 0; i < GRID_SIZE; ++i) {
+            for (int j = 0; j < GRID_SIZE; ++j) {
+                t.units[i][j] = static_cast<std::uint16_t>(i * GRID_SIZE + j);
+                t.units[GRID_SIZE + i][j] = static_cast<std::uint16_t>(j * GRID_SIZE + i);
+                const int row = (i / BoxSize) * BoxSize + j / BoxSize;
+                const int col = (i % BoxSize) * BoxSize + j % BoxSize;
+                t.units[2 * GRID_SIZE + i][j] = static_cast<std::uint16_t>(row * GRID_SIZE + col);
+            }
+            t.units[MAIN_DIAGONAL_UNIT][i] = static_cast<std::uint16_t>(i * GRID_SIZE + i);
+            t.units[ANTI_DIAGONAL_UNIT][i] = static_cast<std::uint16_t>(i * GRID_SIZE + GRID_SIZE - 1 - i);
+        }
+        // Walk the three units of each cell rather than all cell pairs so the
+        // 25x25 tables stay within the compiler's constexpr evaluation limits
+        for (int cell = 0; cell < CELL_COUNT; ++cell) {
+            const CellUnits &u = t.cellUnits[cell];
+            int n = 0;
+            for (int j = 0; j < GRID_SIZE; ++j) {
+                const int inRow = t.units[u.row][j];
+                const int inCol = t.units[GRID_SIZE + u.col][j];
+                const int inBox = t.units[2 * GRID_SIZE + u.box][j];
+                if (inRow != cell) {
+                    t.peers[cell][n++] = static_cast<std::uint16_t>(inRow);
+                }
+                if (inCol != cell) {
+                    t.peers[cell][n++] = static_cast<std::uint16_t>(inCol);
+                }
+                if (t.cellUnits[inBox].row != u.row && t.cellUnits[inBox].col != u.col) {
+                    t.peers[cell][n++] = static_cast<std::uint16_t>(inBox);
+                }
+            }
+        }
+        return t;
+    }
+
+    static constexpr Tables tables = makeTables();
+
+    /**
+     * @brief Number of active units
+     * @param diagonal Whether the diagonals are units too
+     */
+    static constexpr int unitCount(bool diagonal) { return diagonal ? DIAGONAL_UNIT_COUNT : UNIT_COUNT; }
+
+    /** @brief Number of candidates in a mask */
+    static int count(Mask mask) { return static_cast<int>(qPopulationCount(static_cast<std::uint32_t>(mask))); }
+
+    /** @brief Smallest digit in a non-empty mask */
+    static int lowestDigit(Mask mask) { return static_cast<int>(qCountTrailingZeroBits(static_cast<std::uint32_t>(mask))) + 1; }
+
+    /** @brief Mask with only the given digit set */
+    static Mask bit(int num) { return static_cast<Mask>(std::uint32_t(1) << (num - 1)); }
+
+    /**
+     * @brief Builds a state from givens, rejecting conflicts and bad values
+     * @param givens Board with 0 for empty cells
+     * @param state Receives the populated state
+     * @param diagonal Whether the diagonals are units too
+     * @return False if a value is out of range or two givens conflict
+     */
+    static bool load(const Cells &givens, State &state, bool diagonal)
+    {
+        state = State();
+        state.candidates.fill(ALL_DIGITS);
+        for (int cell = 0; cell < CELL_COUNT; ++cell) {
+            const int val = givens[cell];
+            if (val == 0) {
+                continue;
+            }
+            if (val > GRID_SIZE || !(state.candidates[cell] & bit(val))) {
+                return false;
+            }
+            place(state, cell, val, diagonal);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Fill the cell and clear the digit from every unit covering it
+     * @param state State to modify
+     * @param cell Flat cell index
+     * @param num Digit to place (1..GRID_SIZE)
+     * @param diagonal Whether the diagonals are units too
+     */
+    static void place(State &state, int cell, int num, bool diagonal)
+    {
+        const Mask keep = static_cast<Mask>(~bit(num));
+
+        state.cells[cell] = static_cast<std::uint8_t>(num);
+        state.candidates[cell] = 0;
+        --state.emptyCount;
+
+        for (int peer : tables.peers[cell]) {
+            state.candidates[peer] &= keep;
+        }
+
+        // Diagonal constraints only apply when enabled (X-Sudoku variant)
+        if (diagonal) {
+            const CellUnits &u = tables.cellUnits[cell];
+            if (u.onMainDiagonal) {
+                for (int peer : tables.units[MAIN_DIAGONAL_UNIT]) {
+                    state.candidates[peer] &= keep;
+                }
+            }
+            if (u.onAntiDiagonal) {
+                for (int peer : tables.units[ANTI_DIAGONAL_UNIT]) {
+                    state.candidates[peer] &= keep;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Naked singles, hidden singles and locked candidates to a fixpoint
+     *
+     * Cheap singles are repeated until they stall before the box/line
+     * intersection pass (pointing and claiming) runs.
+     * @param state State to reduce in-place
+     * @param diagonal Whether the diagonals are units too
+     * @return False as soon as a contradiction is found
+     */
+    static bool propagate(State &state, bool diagonal)
+    {
+        const int units = unitCount(diagonal);
+
+        for (;;) {
+            bool progress = false;
+
+            // Naked singles: a cell with one candidate must take it
+            for (int cell = 0; cell < CELL_COUNT; ++cell) {
+                if (state.cells[cell] != 0) {
+                    continue;
+                }
+                const Mask mask = state.candidates[cell];
+                if (mask == 0) {
+                    return false; // Empty cell with nowhere to go
+                }
+                if ((mask & (mask - 1)) == 0) {
+                    place(state, cell, lowestDigit(mask), diagonal);
+                    progress = true;
+                }
+            }
+
+            // Hidden singles: a digit with one possible cell in a unit goes there
+            for (int u = 0; u < units; ++u) {
+                Mask once = 0;
+                Mask twice = 0;
+                Mask placed = 0;
+                for (int cell : tables.units[u]) {
+                    const Mask mask = state.candidates[cell];
+                    twice |= once & mask;
+                    once |= mask;
+                    if (state.cells[cell] != 0) {
+                        placed |= bit(state.cells[cell]);
+                    }
+                }
+
+                if ((once | placed) != ALL_DIGITS) {
+                    return false; // Some digit has no cell left in this unit
+                }
+
+                Mask hidden = once & ~twice & ~placed;
+                while (hidden) {
+                    const int num = lowestDigit(hidden);
+                    hidden &= hidden - 1;
+                    for (int cell : tables.units[u]) {
+                        if (state.candidates[cell] & bit(num)) {
+                            place(state, cell, num, diagonal);
+                            progress = true;
+                            break;
+                        }
+                    }
+                }
+            }
+
+            if (progress) {
+                continue;
+            }
+
+            if (!lockedCandidates(state)) {
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @brief Most constrained empty cell (MRV)
+     * @param state Current state
+     * @param cell Receives the chosen cell index
+     * @param cellCandidates Receives that cell's candidate mask
+     * @return True if an empty cell was found, false if the grid is complete.
+     *         A zero candidate mask means the current position is a dead end.
+     */
+    static bool findEmptyCell(const State &state, int &cell, Mask &cellCandidates)
+    {
+        int minOptions = GRID_SIZE + 1;
+        cell = -1;
+
+        for (int i = 0; i < CELL_COUNT; ++i) {
+            if (state.cells[i] != 0) {
+                continue;
+            }
+
+            const Mask mask = state.candidates[i];
+            const int options = count(mask);
+            if (options < minOptions) {
+                minOptions = options;
+                cell = i;
+                cellCandidates = mask;
+
+                // Zero options is a dead end, two is the best left after propagation
+                if (options <= 2) {
+                    break;
+                }
+            }
+        }
+
+        return cell != -1;
+    }
+
+    /**
+     * @brief Propagate-then-branch search for one solution
+     * @param state Start state; holds the solution on success
+     * @param diagonal Whether the diagonals are units too
+     * @param onNode Called once per node with the branching depth; returning
+     *        true aborts the search (budget, cancellation, deadline)
+     * @return True if a solution was found
+     */
+    template <typename NodeHook>
+    static bool solve(State &state, bool diagonal, NodeHook &&onNode)
+    {
+        std::deque<State> frames;
+        return solveFrom(state, diagonal, onNode, frames, 0);
+    }
+
+    /**
+     * @brief Counts solutions, stopping at a limit or when the node budget ends
+     * @param state Start state (consumed)
+     * @param limit Stop once this many solutions are found
+     * @param diagonal Whether the diagonals are units too
+     * @param maxNodes Node budget; when exhausted the result is reported as limit
+     * @return Solutions found, capped at limit
+     */
+    static int countSolutions(State &state, int limit, bool diagonal, std::int64_t maxNodes)
+    {
+        std::deque<State> frames;
+        int found = 0;
+        std::int64_t nodes = 0;
+        countFrom(state, limit, diagonal, found, nodes, maxNodes, frames, 0);
+        return nodes > maxNodes ? limit : found;
+    }
+
+    /**
+     * @brief Search that tries candidate digits in random order
+     *
+     * Used to build complete random grids; starting from an empty state it
+     * produces a uniformly shuffled walk of the solution space.
+     * @param state Start state; holds the filled grid on success
+     * @param rng UniformRandomBitGenerator used to shuffle digit order
+     * @param diagonal Whether the diagonals are units too
+     * @param maxNodes Node budget (the caller retries with a fresh state on failure)
+     * @return True if the grid was completed within the budget
+     */
+    template <typename Rng>
+    static bool fillRandom(State &state, Rng &rng, bool diagonal, std::int64_t maxNodes)
+    {
+        std::deque<State> frames;
+        std::int64_t nodes = 0;
+        return fillFrom(state, rng, diagonal, nodes, maxNodes, frames, 0);
+    }
+
+    /**
+     * @brief Pointing and claiming over every box/line intersection
+     * @param state State to reduce in-place
+     * @return True if any candidate was removed
+     */
+    static bool lockedCandidates(State &state)
+    {
+        bool progress = false;
+
+        for (int box = 0; box < GRID_SIZE; ++box) {
+            const int boxRow = (box / BoxSize) * BoxSize;
+            const int boxCol = (box % BoxSize) * BoxSize;
+
+            for (int horizontal = 0; horizontal < 2; ++horizontal) {
+                // Candidates of the segments this box shares with its lines
+                std::array<Mask, BoxSize> segment{};
+                for (int k = 0; k < BoxSize; ++k) {
+                    for (int j = 0; j < BoxSize; ++j) {
+                        const int cell = horizontal ? (boxRow + k) * GRID_SIZE + boxCol + j
+                                                    : (boxRow + j) * GRID_SIZE + boxCol + k;
+                        segment[k] |= state.candidates[cell];
+                    }
+                }
+
+                for (int k = 0; k < BoxSize; ++k) {
+                    const int line = horizontal ? boxRow + k : boxCol + k;
+                    const Mask inSegment = segment[k];
+                    Mask restOfBox = 0;
+                    for (int other = 0; other < BoxSize; ++other) {
+                        if (other != k) {
+                            restOfBox |= segment[other];
+                        }
+                    }
+
+                    // Candidates of the line outside this box
+                    Mask restOfLine = 0;
+                    for (int j = 0; j < GRID_SIZE; ++j) {
+                        const int cell = horizontal ? line * GRID_SIZE + j : j * GRID_SIZE + line;
+                        if (tables.cellUnits[cell].box != box) {
+                            restOfLine |= state.candidates[cell];
+                        }
+                    }
+
+                    // Pointing: digit confined to this segment within the box
+                    const Mask pointing = inSegment & ~restOfBox & restOfLine;
+                    // Claiming: digit confined to this segment within the line
+                    const Mask claiming = inSegment & ~restOfLine & restOfBox;
+                    if (!pointing && !claiming) {
+                        continue;
+                    }
+
+                    for (int j = 0; j < GRID_SIZE; ++j) {
+                        const int lineCell = horizontal ? line * GRID_SIZE + j : j * GRID_SIZE + line;
+                        if (tables.cellUnits[lineCell].box != box) {
+                            state.candidates[lineCell] &= static_cast<Mask>(~pointing);
+                        }
+                        const int boxCell = tables.units[2 * GRID_SIZE + box][j];
+                        const bool inLine = horizontal ? tables.cellUnits[boxCell].row == line
+                                                       : tables.cellUnits[boxCell].col == line;
+                        if (!inLine) {
+                            state.candidates[boxCell] &= static_cast<Mask>(~claiming);
+                        }
+                    }
+                    progress = true;
+                }
+            }
+        }
+        return progress;
+    }
+
+private:
+    /**
+     * @brief Child state for a branch at the given depth
+     *
+     * States are kept in a deque owned by the top-level call instead of on
+     * the stack: a 25x25 state is ~3 KB and searches can go hundreds deep.
+     */
+    static State &frame(std::deque<State> &frames, int depth)
+    {
+        while (static_cast<int>(frames.size()) <= depth) {
+            frames.emplace_back();
+        }
+        return frames[depth];
+    }
+
+    template <typename NodeHook>
+    static bool solveFrom(State &state, bool diagonal, NodeHook &onNode,
+                          std::deque<State> &frames, int depth)
+    {
+        if (onNode(depth)) {
+            return false;
+        }
+        if (!propagate(state, diagonal)) {
+            return false;
+        }
+
+        int cell;
+        Mask options;
+        if (!findEmptyCell(state, cell, options)) {
+            return true; // No empty cells - solved
+        }
+
+        while (options) {
+            const int num = lowestDigit(options);
+            options &= options - 1;
+
+            State &next = frame(frames, depth);
+            next = state;
+            place(next, cell, num, diagonal);
+            if (solveFrom(next, diagonal, onNode, frames, depth + 1)) {
+                state = next;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void countFrom(State &state, int limit, bool diagonal, int &found,
+                          std::int64_t &nodes, std::int64_t maxNodes,
+                          std::deque<State> &frames, int depth)
+    {
+        if (++nodes > maxNodes || !propagate(state, diagonal)) {
+            return;
+        }
+
+        int cell;
+        Mask options;
+        if (!findEmptyCell(state, cell, options)) {
+            ++found; // Complete grid
+            return;
+        }
+
+        while (options && found < limit && nodes <= maxNodes) {
+            const int num = lowestDigit(options);
+            options &= options - 1;
+
+            State &next = frame(frames, depth);
+            next = state;
+            place(next, cell, num, diagonal);
+            countFrom(next, limit, diagonal, found, nodes, maxNodes, frames, depth + 1);
+        }
+    }
+
+    template <typename Rng>
+    static bool fillFrom(State &state, Rng &rng, bool diagonal, std::int64_t &nodes,
+                         std::int64_t maxNodes, std::deque<State> &frames, int depth)
+    {
+        if (++nodes > maxNodes || !propagate(state, diagonal)) {
+            return false;
+        }
+
+        int cell;
+        Mask options;
+        if (!findEmptyCell(state, cell, options)) {
+            return true;
+        }
+
+        // Shuffle the candidate digits (Fisher-Yates on a small array)
+        std::array<std::uint8_t, GRID_SIZE> digits{};
+        int n = 0;
+        for (Mask m = options; m; m &= m - 1) {
+            digits[n++] = static_cast<std::uint8_t>(lowestDigit(m));
+        }
+        for (int i = n - 1; i > 0; --i) {
+            std::swap(digits[i], digits[rng() % static_cast<unsigned>(i + 1)]);
+        }
+
+        for (int i = 0; i < n; ++i) {
+            State &next = frame(frames, depth);
+            next = state;
+            place(next, cell, digits[i], diagonal);
+            if (fillFrom(next, rng, diagonal, nodes, maxNodes, frames, depth + 1)) {
+                state = next;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+/**
+ * @brief Calls f with std::integral_constant<int, N> for a runtime box size
+ * @param boxSize Box side, 2 to 5
+ * @param f Generic callable taking the integral constant
+ * @return False if boxSize is unsupported (f is not called)
+ */
+template <typename F>
+bool dispatchBoxSize(int boxSize, F &&f)
+{
+    switch (boxSize) {
+    case 2: f(std::integral_constant<int, 2>()); return true;
+    case 3: f(std::integral_constant<int, 3>()); return true;
+    case 4: f(std::integral_constant<int, 4>()); return true;
+    case 5: f(std::integral_constant<int, 5>()); return true;
+    default: return false;
+    }
+}
+
+#endif // SUDOKUENGINE_H
@@ -4,312 +4,1061 @@
  */
 
 #include "SudokuGenerator.h"
+#include "GridFactory.h"
+#include "HistoryIndex.h"
+#include "HistoryWriter.h"
+#include "Solver.h"
+#include "SudokuGrader.h"
+#include "WorkStealingPool.h"
+#include "Xoshiro256.h"
 #include <QDebug>
-#include <QRandomGenerator>
+#include <QDeadlineTimer>
+#include <QMetaMethod>
 #include <algorithm>
+#include <condition_variable>
+#include <mutex>
 #include <random>
-#include <QFile>
-#include <QTextStream>
-#include <QStandardPaths>
-#include <QDir>
 #include <QDateTime>
-#include <cstdlib>
-#include <ctime>
+#include <QStringList>
+
+namespace {
+
+/** @brief Node budget for one random fill attempt before it is restarted */
+constexpr std::int64_t FILL_NODE_BUDGET = 100000;
+
+/**
+ * @brief Searched seed grids per box size behind the transformation stream;
+ * 25x25 seeds take tens of milliseconds each, so that size gets a quarter
+ */
+constexpr int GRID_SEED_COUNT = 16;
+
+/**
+ * @brief Node budget for one 9x9 uniqueness check while removing cells;
+ * scaled down by cell count for larger grids, whose nodes cost more
+ */
+constexpr qint64 UNIQUENESS_NODE_BUDGET = 200000;
+
+/** @brief Default time generateSudoku may spend per call */
+constexpr int DEFAULT_LATENCY_BUDGET_MS = 50;
+
+/** @brief Ready puzzles kept per difficulty unless changed with setPoolCapacity */
+constexpr int DEFAULT_POOL_CAPACITY = 4;
+
+using Technique = SudokuGrader<3>::Technique; // Same numbering for every box size
+
+/** @brief Ratings accepted for one difficulty */
+struct RatingBand {
+    Technique easiest;  ///< The puzzle must need at least this technique
+    Technique hardest;  ///< ...and nothing harder than this one
+    int maxBlanks;      ///< Blank cells on a 9x9 board, scaled for other sizes
+};
+
+RatingBand ratingBand(int difficulty)
+{
+    switch (difficulty) {
+    case 2: // Medium: needs locked candidates or a pair, never more
+        return {Technique::LockedCandidates, Technique::HiddenPair, 81};
+    case 3: // Hard: needs triples, fish, wings, chains or outright search
+        return {Technique::NakedTriple, Technique::Guess, 81};
+    default: // Easy (and invalid input): singles only, plenty of clues
+        return {Technique::NakedSingle, Technique::HiddenSingle, 45};
+    }
+}
+
+QString techniqueName(int technique)
+{
+    return QString(SudokuGrader<3>::techniqueName(static_cast<Technique>(technique)));
+}
+
+/** @brief Cells whose clues are removed together to keep the pattern symmetric */
+using CellGroup = std::vector<int>;
+
+/**
+ * @brief Splits the grid into the orbits of a symmetry, in cell order
+ *
+ * NoSymmetry gives one group per cell, so digging by groups visits cells in
+ * exactly the order the cell-by-cell dig did.
+ */
+template <int BoxSize>
+std::vector<CellGroup> symmetryGroups(SudokuGenerator::Symmetry symmetry)
+{
+    constexpr int size = SudokuEngine<BoxSize>::GRID_SIZE;
+    const auto image = [symmetry](int cell) {
+        const int r = cell / size;
+        const int c = cell % size;
+        switch (symmetry) {
+        case SudokuGenerator::Rotational180:
+            return (size - 1 - r) * size + (size - 1 - c);
+        case SudokuGenerator::Rotational90:
+            return c * size + (size - 1 - r);
+        case SudokuGenerator::MirrorLeftRight:
+            return r * size + (size - 1 - c);
+        case SudokuGenerator::MirrorDiagonal:
+            return c * size + r;
+        default:
+            return cell;
+        }
+    };
+
+    std::vector<CellGroup> groups;
+    std::array<bool, SudokuEngine<BoxSize>::CELL_COUNT> grouped{};
+    for (int cell = 0; cell < size * size; ++cell) {
+        if (grouped[cell]) {
+            continue;
+        }
+        CellGroup group;
+        for (int member = cell; !grouped[member]; member = image(member)) {
+            grouped[member] = true;
+            group.push_back(member);
+        }
+        groups.push_back(std::move(group));
+    }
+    return groups;
+}
+
+/** @brief Outcome of a uniqueness check with a node budget */
+enum class Uniqueness {
+    Unique,      ///< No other solution exists
+    Ambiguous,   ///< Another solution was found
+    OutOfBudget  ///< The search ran out of nodes first; nothing is proved
+};
+
+/**
+ * @brief Whether the puzzle has no solution other than the original one,
+ * given that it was unique before the group's clues were removed
+ *
+ * Any other solution must differ from the original in a removed cell, so
+ * one search per cell for a solution avoiding its original value decides
+ * it; no full solution count is needed.
+ *
+ * @param cells Puzzle with the group's cells blank
+ * @param group Removed cells
+ * @param solution Original complete grid
+ */
+template <int BoxSize>
+Uniqueness uniqueWithout(const typename SudokuEngine<BoxSize>::Cells &cells, const CellGroup &group,
+                   const typename SudokuEngine<BoxSize>::Cells &solution, qint64 maxNodes)
+{
+    using Engine = SudokuEngine<BoxSize>;
+    typename Engine::State loaded;
+    if (!Engine::load(cells, loaded, false)) {
+        return Uniqueness::Ambiguous;
+    }
+
+    for (int cell : group) {
+        typename Engine::State state = loaded;
+        state.candidates[cell] &= static_cast<typename Engine::Mask>(~Engine::bit(solution[cell]));
+        if (state.candidates[cell] == 0) {
+            continue;
+        }
+
+        qint64 nodes = 0;
+        const bool alternative = Engine::solve(state, false, [&nodes, maxNodes](int) {
+            return ++nodes > maxNodes;
+        });
+        if (alternative) {
+            return Uniqueness::Ambiguous;
+        }
+        if (nodes > maxNodes) {
+            return Uniqueness::OutOfBudget;
+        }
+    }
+    return Uniqueness::Unique;
+}
+
+/**
+ * @brief Shared workers for the uniqueness checks of clue reduction
+ *
+ * Shared by every generator instance and the pool thread; each parallelFor
+ * call waits only for its own tasks, so concurrent callers do not block
+ * one another.
+ */
+WorkStealingPool &reductionPool()
+{
+    static WorkStealingPool pool;
+    return pool;
+}
+
+/**
+ * @brief Runs body(0) ... body(count - 1) on the reduction pool and waits
+ * for all of them; runs inline when there is only one worker anyway
+ */
+template <typename Body>
+void parallelFor(int count, const Body &body)
+{
+    WorkStealingPool &pool = reductionPool();
+    if (count < 2 || pool.threadCount() < 2) {
+        for (int i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    int remaining = count;
+    for (int i = 0; i < count; ++i) {
+        pool.submit([&, i]() {
+            body(i);
+            // Notify under the lock: the waiter may return and destroy the
+            // condition variable as soon as it sees remaining reach zero
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--remaining == 0) {
+                finished.notify_all();
+            }
+        });
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&remaining]() { return remaining == 0; });
+}
+
+/**
+ * @brief Whether a puzzle has exactly one solution within a node budget
+ */
+template <int BoxSize>
+bool isUnique(const typename SudokuEngine<BoxSize>::Cells &cells, qint64 maxNodes)
+{
+    using Engine = SudokuEngine<BoxSize>;
+    typename Engine::State state;
+    return Engine::load(cells, state, false) && Engine::countSolutions(state, 2, false, maxNodes) == 1;
+}
+
+/**
+ * @brief Removes clue groups until every remaining one is needed for
+ * uniqueness, with the result a one-at-a-time pass in order would give
+ *
+ * Needing a clue is monotone: if the puzzle is ambiguous without a group,
+ * it stays ambiguous whatever else is removed later. So each round checks
+ * every undecided group concurrently and settles the needed ones for good.
+ * The removable ones may not all go together; a binary search finds the
+ * longest run of them, in order, whose joint removal keeps the puzzle
+ * unique. That run is removed and the group after it is needed (without it
+ * the puzzle was ambiguous). Later groups are checked again next round.
+ *
+ * A group whose check runs out of budget is kept like a needed one, so the
+ * result is minimal only as far as maxNodes could prove: with a budget too
+ * small for the grid, a clue that could go may remain.
+ *
+ * Each round is one step of the dig limit. A round the deadline interrupts
+ * is dropped whole, so the result depends only on the input, the order and
+ * the number of rounds, never on thread timing.
+ *
+ * @param cells Unique puzzle; receives the reduced one
+ * @param solution Its solution
+ * @param groups Fully clued groups in the order they should be tried
+ * @param maxNodes Search budget per uniqueness check
+ * @param deadline Reduction stops when this expires
+ * @param digLimit Stop once tried reaches this (-1: no limit)
+ * @param tried Steps taken so far; advanced once per round
+ * @return False if the deadline or the limit stopped it before it was
+ *         minimal within the budget
+ */
+template <int BoxSize>
+bool reduceToMinimal(typename SudokuEngine<BoxSize>::Cells &cells,
+                     const typename SudokuEngine<BoxSize>::Cells &solution,
+                     std::vector<CellGroup> groups, qint64 maxNodes,
+                     const QDeadlineTimer &deadline, int digLimit, int &tried)
+{
+    using Cells = typename SudokuEngine<BoxSize>::Cells;
+    const auto without = [&cells](const std::vector<CellGroup> &removed, std::size_t count) {
+        Cells reduced = cells;
+        for (std::size_t i = 0; i < count; ++i) {
+            for (int cell : removed[i]) {
+                reduced[cell] = 0;
+            }
+        }
+        return reduced;
+    };
+
+    while (!groups.empty()) {
+        if (tried == digLimit || deadline.hasExpired()) {
+            return false;
+        }
+
+        std::vector<char> removable(groups.size(), 0);
+        parallelFor(static_cast<int>(groups.size()), [&](int i) {
+            if (deadline.hasExpired()) {
+                return; // The round is dropped below
+            }
+            Cells reduced = cells;
+            for (int cell : groups[i]) {
+                reduced[cell] = 0;
+            }
+            removable[i] = uniqueWithout<BoxSize>(reduced, groups[i], solution, maxNodes) == Uniqueness::Unique;
+        });
+
+        if (deadline.hasExpired()) {
+            return false;
+        }
+
+        std::vector<CellGroup> candidates; // Removable on their own, in order
+        for (std::size_t i = 0; i < groups.size(); ++i) {
+            if (removable[i]) {
+                candidates.push_back(std::move(groups[i]));
+            }
+        }
+        if (candidates.empty()) {
+            break;
+        }
+
+        // Longest prefix that can go at once; one group always can
+        std::size_t low = 1;
+        std::size_t high = candidates.size();
+        while (low < high && !deadline.hasExpired()) {
+            const std::size_t mid = (low + high + 1) / 2;
+            if (isUnique<BoxSize>(without(candidates, mid), maxNodes)) {
+                low = mid;
+            } else {
+                high = mid - 1;
+            }
+        }
+        if (deadline.hasExpired()) {
+            return false;
+        }
+        ++tried;
+        cells = without(candidates, low);
+        groups.assign(std::make_move_iterator(candidates.begin() + std::min(low + 1, candidates.size())),
+                      std::make_move_iterator(candidates.end()));
+    }
+    return true;
+}
+
+/**
+ * @brief Shared grid factory for one box size, built on first use
+ *
+ * The seed grids come from a fixed seed, so they are the same in every run
+ * and a puzzle seed only has to pick the transformation and the holes.
+ * Changing this seed or GRID_SEED_COUNT changes every puzzle and needs a
+ * new SudokuGenerator::GENERATOR_VERSION.
+ */
+template <int BoxSize>
+const GridFactory<BoxSize> &gridFactory()
+{
+    static const GridFactory<BoxSize> factory = [] {
+        Xoshiro256 rng(0x5eed0000u + BoxSize);
+        return GridFactory<BoxSize>(rng, BoxSize < 5 ? GRID_SEED_COUNT : GRID_SEED_COUNT / 4,
+                                    FILL_NODE_BUDGET);
+    }();
+    return factory;
+}
+
+} // namespace
 
 /**
  * Constructor for SudokuGenerator
- * Initializes random seed for puzzle generation
+ * Seeds this instance's random generator; it is the only source of
+ * randomness in generation, everything after it is derived from its output
  */
-SudokuGenerator::SudokuGenerator(QObject *parent) : QObject(parent)
+SudokuGenerator::SudokuGenerator(QObject *parent)
+    : QObject(parent),
+      m_solver(new Solver(this)),
+      m_settings{3, DEFAULT_LATENCY_BUDGET_MS, NoSymmetry, false},
+      m_rng((std::uint64_t(std::random_device{}()) << 32) ^ std::random_device{}()),
+      m_lastSeed(0),
+      m_lastDigLimit(-1),
+      m_history(std::make_shared<HistoryIndex>(HistoryStore::defaultPath())),
+      m_stopIndexing(false)
 {
-    // Initialize random seed for consistent random number generation
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
+    // Results of the background solver are re-emitted as our own; the list
+    // form is only built for listeners that still use it
+    connect(m_solver, &Solver::boardSolved, this, [this](bool success, const Board &solution) {
+        emit boardSolved(success, solution);
+        if (isSignalConnected(QMetaMethod::fromSignal(&SudokuGenerator::sudokuSolved))) {
+            emit sudokuSolved(success, solution.toVariantList());
+        }
+    });
+    connect(m_solver, &Solver::solveProgress, this, &SudokuGenerator::solveProgress);
+
+    m_pool = std::make_unique<PuzzlePool>(makeProducer(), DEFAULT_POOL_CAPACITY);
+
+    // Neither delays the first frame; puzzles made before the index is
+    // built cannot be checked against the history
+    const std::shared_ptr<HistoryIndex> history = m_history;
+    m_indexer = std::thread([this, history]() {
+        HistoryStore::migrateDefaultHistory(&m_stopIndexing);
+        history->build(m_stopIndexing);
+    });
+}
+
+/**
+ * Destructor for SudokuGenerator
+ * Both steps check the flag as they go, so quitting waits for at most one
+ * chunk of the legacy history or one record of the store
+ */
+SudokuGenerator::~SudokuGenerator()
+{
+    m_stopIndexing = true;
+    m_indexer.join();
 }
 
 /**
  * Generates a new Sudoku puzzle with the specified difficulty
+ * Without a seed, a puzzle is popped from the pool when one is ready, which
+ * is O(1); on a miss it is generated here within the latency budget. With a
+ * seed the puzzle is rebuilt from it directly.
  * 
  * @param difficulty Difficulty level (1: Easy, 2: Medium, 3: Hard)
+ * @param seed Hexadecimal seed from lastSeed(), or empty for a new puzzle
+ * @return The generated puzzle
+ */
+Board SudokuGenerator::generateBoard(int difficulty, const QString &seed)
+{
+    PuzzlePool::Puzzle puzzle;
+    bool parsed = false;
+    std::uint64_t requested = 0;
+    int digLimit = -1;
+    if (!seed.isEmpty()) {
+        const int slash = seed.indexOf('/');
+        requested = seed.left(slash).toULongLong(&parsed, 16);
+        if (parsed && slash >= 0) {
+            digLimit = seed.mid(slash + 1).toInt(&parsed);
+            parsed = parsed && digLimit >= 0;
+        }
+        if (!parsed) {
+            qDebug() << "Invalid puzzle seed:" << seed;
+        }
+    }
+
+    if (parsed) {
+        puzzle = puzzleFromSeed(m_settings, difficulty, requested, digLimit,
+                                QDeadlineTimer(QDeadlineTimer::Forever));
+    } else if (!m_pool->take(difficulty, puzzle)) {
+        puzzle = generatePuzzle(m_settings, difficulty, m_rng, m_history.get());
+    }
+    solvedGrid = Board::fromGrid(puzzle.solution); // Store the complete solution for later validation
+    m_lastGivens = std::move(puzzle.givens);
+    m_hints.reset(solvedGrid);
+    m_lastTechnique = techniqueName(puzzle.rating);
+    m_lastSeed = puzzle.seed;
+    m_lastDigLimit = puzzle.digLimit;
+
+    // Signal that a new puzzle has been generated
+    const Board board = Board::fromGrid(m_lastGivens);
+    emit puzzleGenerated(board);
+    if (isSignalConnected(QMetaMethod::fromSignal(&SudokuGenerator::sudokuGenerated))) {
+        emit sudokuGenerated(board.toVariantList());
+    }
+    return board;
+}
+
+/**
+ * Generates a new puzzle for callers that take nested lists
+ *
+ * @param difficulty Difficulty level (1: Easy, 2: Medium, 3: Hard)
+ * @param seed Hexadecimal seed from lastSeed(), or empty for a new puzzle
  * @return QVariantList containing the generated puzzle
  */
-QVariantList SudokuGenerator::generateSudoku(int difficulty)
+QVariantList SudokuGenerator::generateSudoku(int difficulty, const QString &seed)
 {
-    // Create an empty grid and fill it with a valid solution
-    Grid grid = generateEmptyGrid();
-    fillGrid(grid);
-    solvedGrid = grid; // Store the complete solution for later validation
+    return generateBoard(difficulty, seed).toVariantList();
+}
 
-    // Determine number of cells to remove based on difficulty
-    int cellsToRemove = 0;
-    switch (difficulty) {
-        case 1: // Easy
-            cellsToRemove = 30; // Approximately 1/3 of cells removed
-            break;
-        case 2: // Medium
-            cellsToRemove = 45; // Half of cells removed
-            break;
-        case 3: // Hard
-            cellsToRemove = 60; // 2/3 of cells removed
+/**
+ * Generates one puzzle for the given settings
+ * Attempts with fresh seeds are made until one lands in the difficulty's
+ * rating band. If the budget runs out first, the attempt whose rating came
+ * closest is used instead; every candidate is unique either way. The
+ * budget only decides how many attempts are made, never what an attempt
+ * produces, so the returned seed always rebuilds the returned puzzle.
+ * Minimal puzzles can come out harder than the band, since reduction
+ * ignores it; for them only the lower bound is sought.
+ * Attempts whose canonical form is in the history index are relabelled or
+ * rotated copies of a played puzzle, and are only used if nothing else
+ * was found in time.
+ * 
+ * @param settings Box size, latency budget, symmetry and minimality
+ * @param difficulty Difficulty level (1: Easy, 2: Medium, 3: Hard)
+ * @param rng Source of the attempt seeds
+ * @param played Puzzles already in the history, or null to skip the check
+ * @return Puzzle, solution, rating and seed
+ */
+PuzzlePool::Puzzle SudokuGenerator::generatePuzzle(const Settings &settings, int difficulty, Xoshiro256 &rng,
+                                                   const HistoryIndex *played)
+{
+    const RatingBand band = ratingBand(difficulty);
+    const int hardest = static_cast<int>(settings.minimal ? Technique::Guess : band.hardest);
+    const QDeadlineTimer deadline(settings.latencyBudgetMs);
+
+    PuzzlePool::Puzzle result;
+    result.rating = -1;
+    bool resultPlayed = false;
+    do {
+        PuzzlePool::Puzzle attempt = puzzleFromSeed(settings, difficulty, rng(), -1, deadline);
+        std::uint64_t hash = 0;
+        const bool attemptPlayed = played && played->size() > 0 &&
+                                   HistoryIndex::puzzleHash(attempt.solution, attempt.givens, hash) &&
+                                   played->contains(hash);
+
+        // Avoid copies of played puzzles; otherwise keep the attempt closest
+        // to the band: below it, harder is closer
+        if (result.rating < 0 || (resultPlayed && !attemptPlayed) ||
+            (!attemptPlayed && attempt.rating <= hardest && attempt.rating > result.rating)) {
+            result = std::move(attempt);
+            resultPlayed = attemptPlayed;
+        }
+        if (!resultPlayed && result.rating >= static_cast<int>(band.easiest)) {
             break;
-        default:
-            cellsToRemove = 30; // Default to Easy if invalid difficulty
+        }
+    } while (!deadline.hasExpired());
+
+    if (resultPlayed) {
+        qDebug() << "Generation budget ran out; puzzle is a copy of one already played";
+    } else if (result.rating < static_cast<int>(band.easiest)) {
+        qDebug() << "Generation budget ran out; puzzle rated" << techniqueName(result.rating);
     }
+    return result;
+}
+
+/**
+ * Builds the single puzzle a seed stands for
+ * Everything random (the solution grid and the order clue groups are
+ * tried in) comes from one Xoshiro256 stream seeded with seed. The deadline
+ * can only end the dig early, and the puzzle records where; replaying with
+ * that dig limit, the same settings and no deadline gives the same puzzle
+ * on every run and machine for the same GENERATOR_VERSION.
+ * 
+ * @param settings Box size, symmetry and minimality
+ * @param difficulty Difficulty level (1: Easy, 2: Medium, 3: Hard)
+ * @param seed Puzzle seed
+ * @param digLimit Groups to try while digging, or -1 for all of them
+ * @param deadline Digging stops early when this expires
+ * @return Puzzle, solution, rating, seed and dig limit
+ */
+PuzzlePool::Puzzle SudokuGenerator::puzzleFromSeed(const Settings &settings, int difficulty, std::uint64_t seed,
+                                                   int digLimit, const QDeadlineTimer &deadline)
+{
+    const int boxSize = settings.boxSize;
+    Xoshiro256 rng(seed);
+    PuzzlePool::Puzzle result;
+    result.seed = seed;
+    result.digLimit = digLimit;
 
-    // Remove cells to create the puzzle
-    removeCells(grid, cellsToRemove);
+    // Create an empty grid and fill it with a valid solution
+    result.givens = generateEmptyGrid(boxSize);
+    fillGrid(result.givens, boxSize, rng);
+    result.solution = result.givens;
 
-    // Convert the C++ grid to QML-compatible format
-    QVariantList qmlGrid;
-    for (const auto &row : grid) {
-        QVariantList qmlRow;
-        for (int cell : row) {
-            qmlRow.append(cell);
-        }
-        qmlGrid.append(QVariant(qmlRow));
+    result.rating = digHoles(result.givens, settings, difficulty, rng, deadline, result.digLimit);
+    return result;
+}
+
+/**
+ * Formats the seed as 16 hexadecimal digits, followed by "/" and the dig
+ * limit when the latency budget cut digging short
+ * 
+ * @return Seed of the last generated puzzle
+ */
+QString SudokuGenerator::lastSeed() const
+{
+    QString seed = QString("%1").arg(m_lastSeed, 16, 16, QChar('0'));
+    if (m_lastDigLimit >= 0) {
+        seed += "/" + QString::number(m_lastDigLimit);
     }
-    
-    // Signal that a new puzzle has been generated
-    emit sudokuGenerated(qmlGrid);
-    return qmlGrid;
+    return seed;
 }
 
 /**
- * Creates an empty 9x9 grid filled with zeros
+ * @return Version of the seed-to-puzzle mapping
+ */
+int SudokuGenerator::generatorVersion() const
+{
+    return GENERATOR_VERSION;
+}
+
+/**
+ * Resizes the pool of ready puzzles
  * 
- * @return Empty grid
+ * @param capacity Puzzles per difficulty; negative values are treated as 0
  */
-SudokuGenerator::Grid SudokuGenerator::generateEmptyGrid()
+void SudokuGenerator::setPoolCapacity(int capacity)
 {
-    // Create a 9x9 grid filled with zeros
-    return Grid(9, std::vector<int>(9, 0));
+    m_pool->setCapacity(capacity);
 }
 
 /**
- * Fills a grid with a valid Sudoku solution
+ * @return Puzzles kept ready per difficulty
+ */
+int SudokuGenerator::poolCapacity() const
+{
+    return m_pool->capacity();
+}
+
+/**
+ * @param difficulty Difficulty level (1 to 3)
+ * @return Puzzles ready right now for that difficulty
+ */
+int SudokuGenerator::pooledPuzzles(int difficulty) const
+{
+    return m_pool->available(difficulty);
+}
+
+/**
+ * @return generateSudoku calls served from the pool
+ */
+qint64 SudokuGenerator::poolHits() const
+{
+    return m_pool->hits();
+}
+
+/**
+ * @return generateSudoku calls that generated synchronously
+ */
+qint64 SudokuGenerator::poolMisses() const
+{
+    return m_pool->misses();
+}
+
+/**
+ * Binds the current settings by value, so the background thread never
+ * reads members the GUI thread may be changing. The producer draws its
+ * attempt seeds from its own generator, seeded from this instance's one;
+ * only the pool thread ever advances it.
+ */
+PuzzlePool::Producer SudokuGenerator::makeProducer()
+{
+    const Settings settings = m_settings;
+    const auto rng = std::make_shared<Xoshiro256>(m_rng());
+    const std::shared_ptr<const HistoryIndex> played = m_history;
+    return [settings, rng, played](int difficulty) {
+        return generatePuzzle(settings, difficulty, *rng, played.get());
+    };
+}
+
+/**
+ * Drops puzzles made with the old settings
+ */
+void SudokuGenerator::resetPool()
+{
+    m_pool->reset(makeProducer());
+}
+
+/**
+ * Sets the per-call generation budget
  * 
- * @param grid Grid to fill
+ * @param milliseconds Budget; values below 1 are clamped to 1
  */
-void SudokuGenerator::fillGrid(Grid &grid)
+void SudokuGenerator::setLatencyBudget(int milliseconds)
 {
-    // Fill the grid with a valid Sudoku solution using backtracking
-    solveSudoku(grid);
+    m_settings.latencyBudgetMs = std::max(1, milliseconds);
+    resetPool();
 }
 
 /**
- * Solves a Sudoku puzzle using backtracking algorithm
- * Uses random number order to generate different solutions
+ * @return Hardest technique needed by the last generated puzzle
+ */
+QString SudokuGenerator::lastTechnique() const
+{
+    return m_lastTechnique;
+}
+
+/**
+ * Selects the grid size used by generateSudoku and the forwarded solver
  * 
- * @param grid Grid to solve
- * @return true if the puzzle was solved, false otherwise
- */
-bool SudokuGenerator::solveSudoku(Grid &grid)
-{
-    // Find an empty cell
-    for (int row = 0; row < 9; ++row) {
-        for (int col = 0; col < 9; ++col) {
-            if (grid[row][col] == 0) {
-                // Try numbers 1-9 in random order for variety in generated puzzles
-                std::vector<int> numbers = {1, 2, 3, 4, 5, 6, 7, 8, 9};
-                
-                // Use standard C++ random shuffle
-                std::random_device rd;
-                std::mt19937 g(rd());
-                std::shuffle(numbers.begin(), numbers.end(), g);
-
-                // Try each number
-                for (int num : numbers) {
-                    if (isValid(grid, row, col, num)) {
-                        grid[row][col] = num;
-                        
-                        // Recursively solve the rest of the grid
-                        if (solveSudoku(grid)) {
-                            return true;
-                        }
-                        
-                        // If we get here, this number didn't work
-                        grid[row][col] = 0; // Backtrack
-                    }
-                }
-                // No valid number found for this cell
-                return false;
-            }
-        }
+ * @param boxSize Side of one box (2 to 5)
+ */
+void SudokuGenerator::setBoxSize(int boxSize)
+{
+    if (boxSize < 2 || boxSize > 5) {
+        qDebug() << "Unsupported box size:" << boxSize;
+        return;
     }
-    // All cells filled successfully
-    return true;
+    m_settings.boxSize = boxSize;
+    m_solver->setBoxSize(boxSize);
+    resetPool();
+}
+
+/**
+ * @return Current box side
+ */
+int SudokuGenerator::boxSize() const
+{
+    return m_settings.boxSize;
 }
 
 /**
- * Checks if a number is valid at a specific position
+ * Selects the clue pattern symmetry
  * 
- * @param grid Grid to check
- * @param row Row index (0-8)
- * @param col Column index (0-8)
- * @param num Number to check (1-9)
- * @return true if the number is valid, false otherwise
+ * @param symmetry A Symmetry value
  */
-bool SudokuGenerator::isValid(const Grid &grid, int row, int col, int num)
+void SudokuGenerator::setSymmetry(int symmetry)
 {
-    // Check row for duplicates
-    for (int x = 0; x < 9; ++x) {
-        if (grid[row][x] == num) {
-            return false;
-        }
+    if (symmetry < NoSymmetry || symmetry > MirrorDiagonal) {
+        qDebug() << "Unsupported symmetry:" << symmetry;
+        return;
     }
+    m_settings.symmetry = static_cast<Symmetry>(symmetry);
+    resetPool();
+}
 
-    // Check column for duplicates
-    for (int x = 0; x < 9; ++x) {
-        if (grid[x][col] == num) {
-            return false;
-        }
-    }
+/**
+ * @return Current clue symmetry
+ */
+int SudokuGenerator::symmetry() const
+{
+    return m_settings.symmetry;
+}
+
+/**
+ * Turns reduction to minimal puzzles on or off
+ * 
+ * @param minimal True for minimal puzzles
+ */
+void SudokuGenerator::setMinimal(bool minimal)
+{
+    m_settings.minimal = minimal;
+    resetPool();
+}
+
+/**
+ * @return Whether generated puzzles are reduced to minimal
+ */
+bool SudokuGenerator::minimal() const
+{
+    return m_settings.minimal;
+}
 
-    // Check 3x3 box for duplicates
-    int startRow = row - row % 3;
-    int startCol = col - col % 3;
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
-            if (grid[i + startRow][j + startCol] == num) {
-                return false;
+/**
+ * Creates an empty grid filled with zeros
+ * 
+ * @param boxSize Side of one box
+ * @return Empty grid
+ */
+SudokuGenerator::Grid SudokuGenerator::generateEmptyGrid(int boxSize)
+{
+    const int size = boxSize * boxSize;
+    return Grid(size, std::vector<int>(size, 0));
+}
+
+/**
+ * Fills a grid with a valid Sudoku solution
+ * The grid is a random transformation of one of a few seed grids. The seeds
+ * are found once per box size by randomized search; every grid after that
+ * costs a single pass over the cells.
+ * 
+ * @param grid Grid to fill
+ * @param boxSize Side of one box
+ * @param rng Chooses the seed grid and the transformation
+ */
+void SudokuGenerator::fillGrid(Grid &grid, int boxSize, Xoshiro256 &rng)
+{
+    dispatchBoxSize(boxSize, [&](auto box) {
+        constexpr int N = decltype(box)::value;
+        using Factory = GridFactory<N>;
+        typename Factory::Cells cells;
+        gridFactory<N>().next(cells, rng);
+
+        for (int r = 0; r < Factory::GRID_SIZE; ++r) {
+            for (int c = 0; c < Factory::GRID_SIZE; ++c) {
+                grid[r][c] = cells[r * Factory::GRID_SIZE + c];
             }
         }
-    }
-    
-    // No duplicates found, number is valid
-    return true;
+    });
 }
 
 /**
- * Removes cells from a grid to create a puzzle
+ * Digs holes in random order, one symmetric group at a time
+ * After each removal the puzzle is graded, with grading cut off as soon as
+ * it needs a technique above the band. If logic completes the grid, the
+ * puzzle is unique with no search at all; only when logic stalls (Hard) is
+ * a search run per removed cell, for a solution that avoids its digit. A
+ * removal that makes the puzzle too hard or ambiguous is undone.
  * 
- * @param grid Grid to modify
- * @param count Number of cells to remove
- */
-void SudokuGenerator::removeCells(Grid &grid, int count)
-{
-    // Remove 'count' cells randomly from the grid
-    int removed = 0;
-    while (removed < count) {
-        // Generate random row and column
-        int row = QRandomGenerator::global()->bounded(9);
-        int col = QRandomGenerator::global()->bounded(9);
-
-        // If cell is not already empty, remove it
-        if (grid[row][col] != 0) {
-            grid[row][col] = 0;
-            removed++;
+ * Stopping at the deadline is the one time-dependent step, so the number
+ * of groups tried by then is reported back; stopping at that count instead
+ * replays the same dig on any machine.
+ * 
+ * In minimal mode the groups the dig kept are then reduced regardless of
+ * band and blank limit. Groups the dig found necessary (another solution
+ * turned up without them) are skipped, since they stay necessary; groups
+ * whose check only ran out of budget are checked again with the larger,
+ * unscaled reduction budget. The result is minimal within that budget,
+ * which on 16x16 and 25x25 grids may leave a redundant clue. Reduction
+ * rounds count as steps after the dig's, so a deadline that cuts reduction
+ * short is recorded the same way (and the puzzle may then not be minimal).
+ * With a symmetry, minimal means no symmetric group can go; single clues
+ * of a group may still be redundant.
+ * 
+ * @param grid Complete grid; receives the puzzle
+ * @param settings Box size, symmetry and minimality
+ * @param difficulty Difficulty level (1: Easy, 2: Medium, 3: Hard)
+ * @param rng Chooses the order groups are tried in
+ * @param deadline Digging stops when this expires
+ * @param digLimit In: stop after this many steps (-1: no limit).
+ *        Out: steps taken if digging or reduction stopped early, else -1
+ * @return Hardest technique the resulting puzzle needs
+ */
+int SudokuGenerator::digHoles(Grid &grid, const Settings &settings, int difficulty, Xoshiro256 &rng,
+                              const QDeadlineTimer &deadline, int &digLimit)
+{
+    const RatingBand band = ratingBand(difficulty);
+    int rating = static_cast<int>(Technique::NakedSingle);
+
+    dispatchBoxSize(settings.boxSize, [&](auto box) {
+        constexpr int N = decltype(box)::value;
+        using Engine = SudokuEngine<N>;
+        using Grader = SudokuGrader<N>;
+        const auto limit = static_cast<typename Grader::Technique>(band.hardest);
+
+        typename Engine::Cells cells{};
+        for (int i = 0; i < Engine::CELL_COUNT; ++i) {
+            cells[i] = static_cast<std::uint8_t>(grid[i / Engine::GRID_SIZE][i % Engine::GRID_SIZE]);
         }
-    }
+        const typename Engine::Cells solution = cells;
+
+        // Visit every group once in random order
+        std::vector<CellGroup> groups = symmetryGroups<N>(settings.symmetry);
+        for (int i = static_cast<int>(groups.size()) - 1; i > 0; --i) {
+            std::swap(groups[i], groups[rng.bounded(i + 1)]);
+        }
+
+        const int maxBlanks = band.maxBlanks * Engine::CELL_COUNT / 81;
+        const qint64 scale = std::max<qint64>(1, qint64(Engine::CELL_COUNT) * Engine::CELL_COUNT / (81 * 81));
+        const qint64 budget = std::max<qint64>(1000, UNIQUENESS_NODE_BUDGET / scale);
+        const qint64 reductionBudget = UNIQUENESS_NODE_BUDGET; // Fewer checks, so not scaled
+
+        std::vector<CellGroup> kept; // Clued groups not yet known to be necessary
+        int blanks = 0;
+        int tried = 0;
+        bool cut = false;
+        for (CellGroup &group : groups) {
+            const int count = static_cast<int>(group.size());
+            if (cut || blanks + count > maxBlanks) {
+                kept.push_back(std::move(group));
+                continue;
+            }
+            if (tried == digLimit || deadline.hasExpired()) {
+                cut = true;
+                kept.push_back(std::move(group));
+                continue;
+            }
+            ++tried;
+
+            for (int cell : group) {
+                cells[cell] = 0;
+            }
+
+            const typename Grader::Grade grade = Grader::grade(cells, false, limit);
+            bool keep = grade.valid && grade.hardest <= limit;
+            bool needed = false;
+            if (keep && !grade.solved) {
+                const Uniqueness unique = uniqueWithout<N>(cells, group, solution, budget);
+                keep = unique == Uniqueness::Unique;
+                needed = unique == Uniqueness::Ambiguous;
+            }
+
+            if (keep) {
+                blanks += count;
+                rating = static_cast<int>(grade.hardest);
+            } else {
+                for (int cell : group) {
+                    cells[cell] = solution[cell];
+                }
+                if (!needed) {
+                    kept.push_back(std::move(group)); // Too hard or undecided, may still go
+                }
+            }
+        }
+
+        if (settings.minimal) {
+            if (!reduceToMinimal<N>(cells, solution, std::move(kept), reductionBudget, deadline, digLimit, tried)) {
+                cut = true;
+            }
+            rating = static_cast<int>(Grader::grade(cells, false, Grader::Technique::Guess).hardest);
+        }
+
+        for (int i = 0; i < Engine::CELL_COUNT; ++i) {
+            grid[i / Engine::GRID_SIZE][i % Engine::GRID_SIZE] = cells[i];
+        }
+        digLimit = cut ? tried : -1;
+    });
+    return rating;
 }
 
 /**
  * Checks if a number matches the solution at a specific position
  * 
- * @param row Row index (0-8)
- * @param col Column index (0-8)
- * @param num Number to check (1-9)
+ * @param row Row index (0 to size-1)
+ * @param col Column index (0 to size-1)
+ * @param num Number to check (1 to size)
  * @return true if the number matches the solution, false otherwise
  */
 bool SudokuGenerator::checkNumber(int row, int col, int num)
 {
     // Validate row and column bounds
-    if (row < 0 || row >= 9 || col < 0 || col >= 9) {
+    const int size = solvedGrid.size();
+    if (row < 0 || row >= size || col < 0 || col >= size) {
         return false;
     }
     
     // Check if the number matches the solution
-    return solvedGrid[row][col] == num;
+    return solvedGrid.at(row, col) == num;
 }
 
 /**
- * Checks if the current puzzle state is correct and complete
- * 
+ * The digit stays in the board either way; only its correctness flag
+ * tells the screen how to show it
+ */
+bool SudokuGenerator::enterNumber(BoardModel *board, int cell, int num)
+{
+    if (!board || board->size() != solvedGrid.size() || board->isGiven(cell)) {
+        return false;
+    }
+    const int size = board->size();
+    board->setValue(cell, num);
+    const bool correct = board->value(cell) == num && checkNumber(cell / size, cell % size, num);
+    board->setCorrect(cell, correct);
+    return correct;
+}
+
+/**
+ * Suggests the next step for the game in progress
+ *
  * @param qmlGrid Current state of the puzzle grid
+ * @return Hint map, empty if there is nothing to suggest
  */
-void SudokuGenerator::checkPuzzle(QVariantList qmlGrid)
+QVariantMap SudokuGenerator::nextHint(QVariantList qmlGrid)
 {
-    // First check if the puzzle is complete (no empty cells)
-    bool isFull = true;
-    for (int i = 0; i < 9; ++i) {
-        QVariantList row = qmlGrid[i].toList();
-        for (int j = 0; j < 9; ++j) {
-            if (row[j].toInt() == 0) {
-                isFull = false;
-                break;
+    return hintFor(Board::fromVariantList(qmlGrid));
+}
+
+QVariantMap SudokuGenerator::nextHint(const Board &board)
+{
+    return hintFor(board);
+}
+
+QVariantMap SudokuGenerator::boardHint(BoardModel *board)
+{
+    return board ? hintFor(board->board()) : QVariantMap();
+}
+
+/**
+ * Asks the HintEngine for the next step and converts it for QML. Rows and
+ * columns are 0-based in the map and 1-based in the text.
+ */
+QVariantMap SudokuGenerator::hintFor(const Board &board)
+{
+    QVariantMap result;
+    HintEngine::Hint hint;
+    if (!m_hints.nextHint(board, hint) || hint.kind == HintEngine::Kind::None) {
+        return result;
+    }
+
+    const int size = solvedGrid.size();
+    const auto cellName = [size](int cell) {
+        return QString("r%1c%2").arg(cell / size + 1).arg(cell % size + 1);
+    };
+    const auto position = [size](int cell) {
+        QVariantMap map;
+        map["row"] = cell / size;
+        map["col"] = cell % size;
+        return map;
+    };
+
+    QString text;
+    if (hint.kind == HintEngine::Kind::Mistake) {
+        result["kind"] = "mistake";
+        text = QString("The digit in %1 is wrong").arg(cellName(hint.cell));
+    } else {
+        result["technique"] = techniqueName(hint.technique);
+        if (hint.kind == HintEngine::Kind::Placement) {
+            result["kind"] = "placement";
+            result["value"] = hint.digit;
+            if (hint.technique == static_cast<int>(Technique::Guess)) {
+                text = QString("No logical step left; %1 is %2").arg(cellName(hint.cell)).arg(hint.digit);
+            } else {
+                text = QString("%1: %2 must be %3")
+                           .arg(techniqueName(hint.technique), cellName(hint.cell))
+                           .arg(hint.digit);
             }
+        } else {
+            result["kind"] = "elimination";
+            QVariantList eliminations;
+            QStringList removed;
+            for (const auto &elimination : hint.eliminations) {
+                QVariantList digits;
+                QStringList names;
+                for (std::uint32_t m = elimination.second; m; m &= m - 1) {
+                    const int digit = static_cast<int>(qCountTrailingZeroBits(m)) + 1;
+                    digits.append(digit);
+                    names.append(QString::number(digit));
+                }
+                QVariantMap entry = position(elimination.first);
+                entry["digits"] = digits;
+                eliminations.append(entry);
+                removed.append(QString("%1 from %2").arg(names.join(","), cellName(elimination.first)));
+            }
+            result["eliminations"] = eliminations;
+            text = QString("%1: remove %2").arg(techniqueName(hint.technique), removed.join("; "));
         }
-        if (!isFull) {
-            break;
-        }
+    }
+    if (hint.cell >= 0) {
+        result["row"] = hint.cell / size;
+        result["col"] = hint.cell % size;
     }
 
-    // If puzzle is incomplete, notify UI
-    if (!isFull) {
-        emit puzzleChecked(-1); // Incomplete
-        return;
+    QVariantList support;
+    for (int cell : hint.support) {
+        support.append(position(cell));
     }
+    result["support"] = support;
+    result["text"] = text;
+    return result;
+}
 
-    // Check if the puzzle matches the solution
-    bool isCorrect = true;
-    for (int i = 0; i < 9; ++i) {
-        QVariantList row = qmlGrid[i].toList();
-        for (int j = 0; j < 9; ++j) {
-            if (row[j].toInt() != solvedGrid[i][j]) {
-                isCorrect = false;
-                break;
-            }
-        }
-        if (!isCorrect) {
-            break;
-        }
+/**
+ * Checks if the current puzzle state is correct and complete
+ * 
+ * @param qmlGrid Current state of the puzzle grid
+ */
+void SudokuGenerator::checkPuzzle(QVariantList qmlGrid)
+{
+    emit puzzleChecked(checkGrid(Board::fromVariantList(qmlGrid)));
+}
+
+void SudokuGenerator::checkPuzzle(const Board &board)
+{
+    emit puzzleChecked(checkGrid(board));
+}
+
+void SudokuGenerator::checkBoard(BoardModel *board)
+{
+    emit puzzleChecked(board ? checkGrid(board->board()) : 0);
+}
+
+int SudokuGenerator::checkGrid(const Board &board) const
+{
+    if (!solvedGrid.isValid() || board.boxSize() != solvedGrid.boxSize()) {
+        return 0; // No puzzle generated yet, or wrong shape
     }
 
-    // Notify UI of the result
-    if (isCorrect) {
-        emit puzzleChecked(1); // Correct
-    } else {
-        emit puzzleChecked(0); // Incorrect
+    // First check if the puzzle is complete (no empty cells)
+    if (!board.isComplete()) {
+        return -1; // Incomplete
     }
+
+    // Check if the puzzle matches the solution
+    return board == solvedGrid ? 1 : 0;
 }
 
 /**
  * Solves a given puzzle
+ * The work is done by the background Solver; its sudokuSolved signal is
+ * forwarded, so the result arrives asynchronously on the GUI thread
  * 
  * @param qmlGrid Current state of the puzzle grid
  */
 void SudokuGenerator::solvePuzzle(QVariantList qmlGrid)
 {
-    // Convert QML grid to C++ grid
-    Grid grid(9, std::vector<int>(9));
-    for (int i = 0; i < 9; ++i) {
-        QVariantList row = qmlGrid[i].toList();
-        for (int j = 0; j < 9; ++j) {
-            grid[i][j] = row[j].toInt();
-        }
-    }
+    m_solver->solvePuzzle(qmlGrid);
+}
 
-    // Solve the puzzle
-    Grid solved = grid;
-    bool solvable = solveSudoku(solved);
-
-    // Convert solution back to QML format
-    QVariantList qmlSolution;
-    if (solvable) {
-        for (const auto &row : solved) {
-            QVariantList qmlRow;
-            for (int cell : row) {
-                qmlRow.append(cell);
-            }
-            qmlSolution.append(QVariant(qmlRow));
-        }
-    }
-    
-    // Signal the result back to QML
-    emit sudokuSolved(solvable, qmlSolution);
+void SudokuGenerator::solvePuzzle(const Board &board)
+{
+    m_solver->solvePuzzle(board);
 }
 
 /**
- * Saves a completed puzzle to the history file
+ * Saves a completed puzzle to the history store
  * 
  * @param qmlGrid Completed puzzle grid
  * @param time Time taken to complete the puzzle (in seconds)
@@ -317,36 +1066,50 @@ void SudokuGenerator::solvePuzzle(QVariantList qmlGrid)
  */
 void SudokuGenerator::savePuzzle(QVariantList qmlGrid, int time, int difficulty)
 {
-    // Get the documents directory path
-    QString path = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
-    
-    // Create directory if it doesn't exist
-    QDir dir(path);
-    if (!dir.exists("SudokuPuzzles")) {
-        dir.mkdir("SudokuPuzzles");
+    saveGrid(Board::fromVariantList(qmlGrid), time, difficulty);
+}
+
+void SudokuGenerator::savePuzzle(const Board &board, int time, int difficulty)
+{
+    saveGrid(board, time, difficulty);
+}
+
+void SudokuGenerator::saveBoard(BoardModel *board, int time, int difficulty)
+{
+    if (board) {
+        saveGrid(board->board(), time, difficulty);
     }
-    
-    // Open file for appending
-    QString filePath = path + "/SudokuPuzzles/solved_puzzles_history.txt";
-    QFile file(filePath);
-    if (file.open(QIODevice::Append | QIODevice::Text)) {
-        QTextStream out(&file);
-        
-        // Write puzzle metadata
-        out << "--- Puzzle Entry ---\n";
-        out << "Date: " << QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss") << "\n";
-        out << "Completion Time (seconds): " << time << "\n";
-        out << "Difficulty: " << difficulty << "\n";
-        out << "Puzzle:\n";
-        
-        // Write puzzle grid
-        for (int i = 0; i < 9; ++i) {
-            QVariantList row = qmlGrid[i].toList();
-            for (int j = 0; j < 9; ++j) {
-                out << row[j].toInt() << " ";
-            }
-            out << "\n";
-        }
-        file.close();
+}
+
+void SudokuGenerator::saveGrid(const Board &board, int time, int difficulty)
+{
+    if (!board.isValid()) {
+        qDebug() << "Not saving a malformed puzzle";
+        return;
+    }
+
+    // Clues of the game, so the history index can recognise copies of it
+    HistoryStore::Entry entry;
+    entry.timestamp = QDateTime::currentSecsSinceEpoch();
+    entry.time = time;
+    entry.difficulty = difficulty;
+    entry.grid = board;
+    entry.givens = Board::fromGrid(m_lastGivens);
+    if (entry.givens.boxSize() != board.boxSize()) {
+        entry.givens = Board();
     }
+
+    // Indexed once the writer has stored it, so the index never runs ahead;
+    // an entry without a hash still moves the covered size on
+    std::uint64_t hash = 0;
+    const bool hashed = entry.givens.isValid() &&
+                        HistoryIndex::puzzleHash(solvedGrid.toGrid(), m_lastGivens, hash);
+    const std::shared_ptr<HistoryIndex> history = m_history;
+    HistoryWriter::forDefaultStore().enqueue(entry, [history, hashed, hash](qint64 storeSize) {
+        if (hashed) {
+            history->insert(hash, storeSize);
+        } else {
+            history->skip(storeSize);
+        }
+    });
 }
\ No newline at end of file
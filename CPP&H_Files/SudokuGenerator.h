@@ -6,6 +6,7 @@
  * - Generating valid Sudoku puzzles with varying difficulty levels
  * - Validating user inputs against the solution
  * - Checking if a puzzle is complete and correct
+ * - Suggesting the next logical step of the game in progress
  * - Saving completed puzzles to a history file
  */
 
@@ -14,7 +15,22 @@
 
 #include <QObject>
 #include <QVariantList>
+#include <QVariantMap>
+#include <QDeadlineTimer>
+#include <QString>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
 #include <vector>
+#include "Board.h"
+#include "BoardModel.h"
+#include "HintEngine.h"
+#include "PuzzlePool.h"
+#include "Xoshiro256.h"
+
+class HistoryIndex;
+class Solver;
 
 /**
  * @class SudokuGenerator
@@ -22,45 +38,240 @@
  * 
  * The SudokuGenerator class provides functionality to create Sudoku puzzles,
  * validate user inputs, and check if a puzzle has been solved correctly.
- * It also handles saving completed puzzles to a history file.
+ * Difficulty is set by the techniques a puzzle needs, as rated by
+ * SudokuGrader, rather than by how many cells are blank.
+ * A PuzzlePool keeps a few puzzles per difficulty ready in the background,
+ * so a new game usually starts without waiting for generation.
+ * Clues can be removed in symmetric groups, and puzzles can be reduced
+ * until no clue (or symmetric group of clues) can go without losing
+ * uniqueness.
+ * Every puzzle is determined by its 64-bit seed, its difficulty, the box
+ * size, the symmetry and minimal settings and GENERATOR_VERSION (plus a
+ * step count when the latency budget cut digging short), so a game can be
+ * shared or stored as a seed and rebuilt instead of saving the grid.
+ * It also handles saving completed puzzles to a history file, and uses a
+ * HistoryIndex of it to avoid serving copies of puzzles already played.
  */
 class SudokuGenerator : public QObject
 {
     Q_OBJECT
 public:
+    /** @brief Symmetry of the clue pattern */
+    enum Symmetry {
+        NoSymmetry,
+        Rotational180,   ///< Unchanged by a half turn
+        Rotational90,    ///< Unchanged by a quarter turn
+        MirrorLeftRight, ///< Unchanged by reflection across the vertical axis
+        MirrorDiagonal   ///< Unchanged by reflection across the main diagonal
+    };
+    Q_ENUM(Symmetry)
+
     /**
      * @brief Constructor for SudokuGenerator
      * @param parent Parent QObject (default: nullptr)
      */
     explicit SudokuGenerator(QObject *parent = nullptr);
 
+    /**
+     * @brief Destructor for SudokuGenerator
+     * Abandons a history migration or index build still in progress
+     */
+    ~SudokuGenerator() override;
+
+    /**
+     * @brief Version of the seed-to-puzzle mapping; bump it whenever a change
+     * makes an existing seed produce a different puzzle
+     */
+    static constexpr int GENERATOR_VERSION = 1;
+
     /**
      * @brief Generates a new Sudoku puzzle
      * @param difficulty Difficulty level (1: Easy, 2: Medium, 3: Hard)
+     * @param seed Seed from lastSeed() to rebuild that puzzle; empty for a
+     *        new one
+     * @return The generated puzzle
+     *
+     * A new puzzle is served from the pre-generated pool when it has one
+     * ready; otherwise it is generated on the spot. Emits puzzleGenerated,
+     * and sudokuGenerated if anything is connected to it.
+     */
+    Q_INVOKABLE Board generateBoard(int difficulty, const QString &seed = QString());
+
+    /**
+     * @brief generateBoard with the puzzle as QVariantList rows
+     * @param difficulty Difficulty level (1: Easy, 2: Medium, 3: Hard)
+     * @param seed Seed from lastSeed(), or empty for a new puzzle
      * @return QVariantList containing the generated puzzle
      */
-    Q_INVOKABLE QVariantList generateSudoku(int difficulty);
+    Q_INVOKABLE QVariantList generateSudoku(int difficulty, const QString &seed = QString());
+
+    /**
+     * @brief Seed of the last generated puzzle
+     * @return 16 hexadecimal digits, plus "/<steps>" if digging was cut
+     *        short; pass it back to generateSudoku with the same difficulty,
+     *        box size, symmetry and minimal setting to get the same puzzle
+     */
+    Q_INVOKABLE QString lastSeed() const;
+
+    /**
+     * @brief GENERATOR_VERSION, for storing next to saved seeds
+     */
+    Q_INVOKABLE int generatorVersion() const;
+
+    /**
+     * @brief Sets how many ready puzzles are kept per difficulty
+     * @param capacity Puzzles per difficulty; 0 turns pre-generation off
+     */
+    Q_INVOKABLE void setPoolCapacity(int capacity);
+
+    /**
+     * @brief Puzzles kept ready per difficulty
+     */
+    Q_INVOKABLE int poolCapacity() const;
+
+    /**
+     * @brief Puzzles ready right now for a difficulty
+     * @param difficulty Difficulty level (1 to 3)
+     */
+    Q_INVOKABLE int pooledPuzzles(int difficulty) const;
+
+    /**
+     * @brief Number of generateSudoku calls served from the pool
+     */
+    Q_INVOKABLE qint64 poolHits() const;
+
+    /**
+     * @brief Number of generateSudoku calls that had to generate synchronously
+     */
+    Q_INVOKABLE qint64 poolMisses() const;
+
+    /**
+     * @brief Sets how long generateSudoku may search for an in-band puzzle
+     * @param milliseconds Budget per call; when it runs out the closest
+     *        unique puzzle found so far is returned
+     */
+    Q_INVOKABLE void setLatencyBudget(int milliseconds);
+
+    /**
+     * @brief Name of the hardest technique the last generated puzzle needs
+     * @return E.g. "Hidden Single", "X-Wing", or "Guess" when logic alone stalls
+     */
+    Q_INVOKABLE QString lastTechnique() const;
+
+    /**
+     * @brief Selects the grid size for generation, checking and solving
+     * @param boxSize Side of one box: 2 (4x4), 3 (9x9, default), 4 (16x16) or 5 (25x25)
+     */
+    Q_INVOKABLE void setBoxSize(int boxSize);
+
+    /**
+     * @brief Current box side
+     */
+    Q_INVOKABLE int boxSize() const;
+
+    /**
+     * @brief Selects the symmetry of generated clue patterns
+     * @param symmetry A Symmetry value; clues are removed one symmetric
+     *        group at a time
+     */
+    Q_INVOKABLE void setSymmetry(int symmetry);
+
+    /**
+     * @brief Current clue symmetry (a Symmetry value)
+     */
+    Q_INVOKABLE int symmetry() const;
+
+    /**
+     * @brief Turns minimal-puzzle generation on or off
+     * @param minimal If true, after digging within the difficulty band every
+     *        clue group that can still go without losing uniqueness is
+     *        removed, whatever that does to the rating; the difficulty then
+     *        only sets the minimum rating. Uniqueness checks have a node
+     *        budget, so on large grids a clue the search could not settle
+     *        may remain
+     */
+    Q_INVOKABLE void setMinimal(bool minimal);
+
+    /**
+     * @brief Whether minimal-puzzle generation is on
+     */
+    Q_INVOKABLE bool minimal() const;
 
     /**
      * @brief Checks if a number is valid at a specific position
-     * @param row Row index (0-8)
-     * @param col Column index (0-8)
-     * @param num Number to check (1-9)
+     * @param row Row index (0 to size-1)
+     * @param col Column index (0 to size-1)
+     * @param num Number to check (1 to size)
      * @return true if the number matches the solution, false otherwise
      */
     Q_INVOKABLE bool checkNumber(int row, int col, int num);
+
+    /**
+     * @brief Enters a digit into a board and flags it against the solution
+     * @param board Board of the game in progress
+     * @param cell Cell index (row-major)
+     * @param num Digit to enter (1 to size)
+     * @return True if the digit matches the solution
+     */
+    Q_INVOKABLE bool enterNumber(BoardModel *board, int cell, int num);
+
+    /**
+     * @brief Next logical step for the game in progress
+     * @param currentGrid Current state of the puzzle grid
+     * @return Map with "kind" ("mistake", "placement" or "elimination"),
+     *         "technique", "row", "col" and "value" of the cell to fix or
+     *         fill, "eliminations" (list of {row, col, digits}), "support"
+     *         (list of {row, col}) and a one-line "text"; empty when the
+     *         board is complete or does not belong to the current game
+     */
+    Q_INVOKABLE QVariantMap nextHint(QVariantList currentGrid);
+
+    /**
+     * @brief nextHint for a Board
+     * @param board Current state of the puzzle grid
+     * @return Hint map as from the QVariantList form
+     */
+    Q_INVOKABLE QVariantMap nextHint(const Board &board);
+
+    /**
+     * @brief nextHint for a BoardModel
+     * @param board Board of the game in progress
+     * @return Hint map as from nextHint
+     */
+    Q_INVOKABLE QVariantMap boardHint(BoardModel *board);
     
     /**
      * @brief Checks if the current puzzle state is correct and complete
      * @param currentGrid Current state of the puzzle grid
      */
     Q_INVOKABLE void checkPuzzle(QVariantList currentGrid);
+
+    /**
+     * @brief checkPuzzle for a Board
+     * @param board Current state of the puzzle grid
+     */
+    Q_INVOKABLE void checkPuzzle(const Board &board);
+
+    /**
+     * @brief checkPuzzle for a BoardModel
+     * @param board Board of the game in progress
+     */
+    Q_INVOKABLE void checkBoard(BoardModel *board);
     
     /**
-     * @brief Solves a given puzzle
+     * @brief Solves a given puzzle asynchronously
      * @param grid Current state of the puzzle grid
+     *
+     * Forwards to an internal Solver, so the search runs off the GUI thread,
+     * a new call cancels the previous one and boardSolved arrives queued.
      */
     Q_INVOKABLE void solvePuzzle(QVariantList grid);
+
+    /**
+     * @brief solvePuzzle for a Board
+     * @param board Puzzle to solve
+     */
+    Q_INVOKABLE void solvePuzzle(const Board &board);
     
     /**
      * @brief Saves a completed puzzle to the history file
@@ -70,19 +281,57 @@ public:
      */
     Q_INVOKABLE void savePuzzle(QVariantList grid, int time, int difficulty);
 
+    /**
+     * @brief savePuzzle for a Board
+     * @param board Completed puzzle grid
+     * @param time Time taken to complete the puzzle (in seconds)
+     * @param difficulty Difficulty level of the puzzle
+     */
+    Q_INVOKABLE void savePuzzle(const Board &board, int time, int difficulty);
+
+    /**
+     * @brief savePuzzle for a BoardModel
+     * @param board Completed board
+     * @param time Time taken to complete the puzzle (in seconds)
+     * @param difficulty Difficulty level of the puzzle
+     */
+    Q_INVOKABLE void saveBoard(BoardModel *board, int time, int difficulty);
+
 signals:
     /**
      * @brief Signal emitted when a new puzzle is generated
      * @param puzzle The generated puzzle
      */
+    void puzzleGenerated(const Board &puzzle);
+
+    /**
+     * @brief puzzleGenerated as QVariantList rows; only built while
+     * something is connected
+     * @param puzzle The generated puzzle
+     */
     void sudokuGenerated(QVariantList puzzle);
-    
+
     /**
      * @brief Signal emitted when a puzzle is solved
      * @param success Whether the puzzle was successfully solved
+     * @param solution The solution grid (invalid if unsolvable)
+     */
+    void boardSolved(bool success, const Board &solution);
+    
+    /**
+     * @brief boardSolved as QVariantList rows; only built while something
+     * is connected
+     * @param success Whether the puzzle was successfully solved
      * @param solution The solution grid
      */
     void sudokuSolved(bool success, QVariantList solution);
+
+    /**
+     * @brief Signal emitted periodically while solvePuzzle is running
+     * @param nodes Search nodes visited so far
+     * @param depth Current branching depth
+     */
+    void solveProgress(qint64 nodes, int depth);
     
     /**
      * @brief Signal emitted when a puzzle is checked
@@ -95,43 +344,129 @@ private:
     using Grid = std::vector<std::vector<int>>;
     
     /** @brief Stores the solved grid for validation */
-    Grid solvedGrid;
-    
+    Board solvedGrid;
+
+    /** @brief Background solver behind solvePuzzle (child object) */
+    Solver *m_solver;
+
+    /** @brief Everything besides the seed and difficulty that shapes a puzzle */
+    struct Settings {
+        int boxSize;           ///< Side of one box; the grid is boxSize² cells across
+        int latencyBudgetMs;   ///< Time generateSudoku may spend looking for an in-band puzzle
+        Symmetry symmetry;     ///< Clue pattern symmetry
+        bool minimal;          ///< Reduce to a minimal puzzle after digging
+    };
+
+    /** @brief Current generation settings */
+    Settings m_settings;
+
+    /** @brief Hardest technique needed by the last generated puzzle */
+    QString m_lastTechnique;
+
+    /** @brief This instance's random generator; all generation derives from it */
+    Xoshiro256 m_rng;
+
+    /** @brief Seed of the last generated puzzle */
+    std::uint64_t m_lastSeed;
+
+    /** @brief Dig limit of the last generated puzzle (-1: dug completely) */
+    int m_lastDigLimit;
+
+    /** @brief Candidate state behind nextHint, reset with every new puzzle */
+    HintEngine m_hints;
+
+    /** @brief Clues of the last generated puzzle, recorded by savePuzzle */
+    Grid m_lastGivens;
+
+    /** @brief Canonical hashes of played puzzles; shared with the pool thread */
+    std::shared_ptr<HistoryIndex> m_history;
+
+    /** @brief Set to abandon the work of m_indexer */
+    std::atomic<bool> m_stopIndexing;
+
+    /** @brief Migrates the legacy history and builds m_history */
+    std::thread m_indexer;
+
+    /** @brief Background buffer of ready puzzles for the current settings */
+    std::unique_ptr<PuzzlePool> m_pool;
+
     /**
-     * @brief Creates an empty 9x9 grid
-     * @return Empty grid filled with zeros
+     * @brief Compares a board with the solution
+     * @return 1 = correct, 0 = incorrect or wrong shape, -1 = incomplete
      */
-    Grid generateEmptyGrid();
-    
+    int checkGrid(const Board &board) const;
+
+    /** @brief Builds the nextHint map for a board */
+    QVariantMap hintFor(const Board &board);
+
+    /** @brief Queues a completed board for the history writer */
+    void saveGrid(const Board &board, int time, int difficulty);
+
     /**
-     * @brief Fills a grid with a valid Sudoku solution
-     * @param grid Grid to fill
+     * @brief Pool producer for the current settings
+     */
+    PuzzlePool::Producer makeProducer();
+
+    /**
+     * @brief Points the pool at the current settings, dropping puzzles made
+     * with the old ones
+     */
+    void resetPool();
+
+    /**
+     * @brief Generates one puzzle with its solution; touches no members, so
+     * the pool's background thread can call it too
+     * @param settings Box size, latency budget, symmetry and minimality
+     * @param difficulty Difficulty level (1: Easy, 2: Medium, 3: Hard)
+     * @param rng Source of the attempt seeds; owned by the calling thread
+     * @param played Puzzles already in the history (null: no check)
+     * @return Puzzle, solution, rating and the seed that rebuilds it
      */
-    void fillGrid(Grid &grid);
+    static PuzzlePool::Puzzle generatePuzzle(const Settings &settings, int difficulty, Xoshiro256 &rng,
+                                             const HistoryIndex *played);
+
+    /**
+     * @brief Builds the one puzzle a seed stands for, with no retries
+     * @param settings Box size, symmetry and minimality
+     * @param difficulty Difficulty level (1: Easy, 2: Medium, 3: Hard)
+     * @param seed Puzzle seed
+     * @param digLimit Removal steps to try while digging, or -1 for all of them
+     * @param deadline Digging stops early when this expires
+     * @return Puzzle, solution, rating, seed and dig limit
+     */
+    static PuzzlePool::Puzzle puzzleFromSeed(const Settings &settings, int difficulty, std::uint64_t seed,
+                                             int digLimit, const QDeadlineTimer &deadline);
     
     /**
-     * @brief Solves a Sudoku puzzle using backtracking
-     * @param grid Grid to solve
-     * @return true if the puzzle was solved, false otherwise
+     * @brief Creates an empty grid
+     * @param boxSize Side of one box
+     * @return Empty grid filled with zeros
      */
-    bool solveSudoku(Grid &grid);
+    static Grid generateEmptyGrid(int boxSize);
     
     /**
-     * @brief Checks if a number is valid at a specific position
-     * @param grid Grid to check
-     * @param row Row index (0-8)
-     * @param col Column index (0-8)
-     * @param num Number to check (1-9)
-     * @return true if the number is valid, false otherwise
+     * @brief Fills a grid with a random valid Sudoku solution
+     * @param grid Grid to fill
+     * @param boxSize Side of one box
+     * @param rng Random stream of the puzzle being built
      */
-    bool isValid(const Grid &grid, int row, int col, int num);
+    static void fillGrid(Grid &grid, int boxSize, Xoshiro256 &rng);
     
     /**
-     * @brief Removes cells from a grid to create a puzzle
-     * @param grid Grid to modify
-     * @param count Number of cells to remove
+     * @brief Digs holes one symmetric group at a time, keeping each removal
+     * only while the puzzle stays unique and no harder than the difficulty
+     * allows, then reduces to minimal if the settings ask for it
+     * @param grid Complete grid; receives the puzzle
+     * @param settings Box size, symmetry and minimality
+     * @param difficulty Difficulty level (1: Easy, 2: Medium, 3: Hard)
+     * @param rng Random stream of the puzzle being built
+     * @param deadline Digging stops early when this expires
+     * @param digLimit In: removal steps to take (-1: all). Out: steps taken
+     *        if digging or reduction stopped early, else -1
+     * @return Hardest technique the puzzle needs (SudokuGrader::Technique as int)
      */
-    void removeCells(Grid &grid, int count);
+    static int digHoles(Grid &grid, const Settings &settings, int difficulty, Xoshiro256 &rng,
+                        const QDeadlineTimer &deadline, int &digLimit);
 };
 
 #endif // SUDOKUGENERATOR_H
\ No newline at end of file
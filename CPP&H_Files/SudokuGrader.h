@@ -0,0 +1,878 @@
+/**
+ * @file SudokuGrader.h
+ * @brief Header-only human-style difficulty grader templated on the box size
+ *
+ * This header is responsible for:
+ * - Solving a puzzle with logical techniques only, easiest first: singles,
+ *   locked candidates, subsets, fish, wings and chains
+ * - Recording the hardest technique the puzzle needs and how often each was used
+ * - Turning that into a numeric rating for sorting puzzle libraries
+ * - Proving uniqueness for free whenever logic alone completes the grid
+ * - Reporting single deductions with the cells they rest on, for hints
+ */
+
+#ifndef SUDOKUGRADER_H
+#define SUDOKUGRADER_H
+
+#include "SudokuEngine.h"
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+/**
+ * @class SudokuGrader
+ * @brief Rates puzzles by the techniques a human solver would need
+ *
+ * The grader repeatedly applies the easiest technique that makes progress,
+ * restarting from naked singles after every step, so the hardest technique
+ * recorded is one the puzzle cannot be solved without (given this ordering).
+ * When no technique applies the puzzle is rated Technique::Guess.
+ *
+ * Every deduction is sound for any solution of the puzzle, so a grade with
+ * solved == true also proves the puzzle has exactly one solution.
+ */
+template <int BoxSize>
+class SudokuGrader
+{
+public:
+    using Engine = SudokuEngine<BoxSize>;
+    using State = typename Engine::State;
+    using Cells = typename Engine::Cells;
+    using Mask = typename Engine::Mask;
+
+    /** @brief Techniques in increasing order of difficulty */
+    enum class Technique {
+        NakedSingle,
+        HiddenSingle,
+        LockedCandidates, ///< Pointing and claiming
+        NakedPair,
+        HiddenPair,
+        NakedTriple,
+        HiddenTriple,
+        XWing,
+        Swordfish,
+        XYWing,
+        XYZWing,
+        SimpleColouring,  ///< Conjugate-pair chains of one digit
+        XYChain,          ///< Chains of bivalue cells
+        Guess             ///< Logic stalled; a solver would have to search
+    };
+    static constexpr int TECHNIQUE_COUNT = static_cast<int>(Technique::Guess) + 1;
+
+    /** @brief Result of grading one puzzle */
+    struct Grade {
+        bool valid = true;            ///< False if the givens conflict or logic hit a contradiction
+        bool solved = false;          ///< Completed by logic alone (and therefore unique)
+        Technique hardest = Technique::NakedSingle;
+        std::array<int, TECHNIQUE_COUNT> uses{}; ///< Successful steps per technique
+
+        /**
+         * @brief Numeric difficulty for sorting
+         * @return The integer part is the hardest technique, 1 (naked single)
+         *         to TECHNIQUE_COUNT (guess); the fraction grows with the
+         *         number of steps beyond singles, so puzzles needing the same
+         *         technique more often sort later, without crossing into the
+         *         next technique
+         */
+        double rating() const
+        {
+            int advanced = 0;
+            for (int t = static_cast<int>(Technique::LockedCandidates); t < TECHNIQUE_COUNT; ++t) {
+                advanced += uses[t];
+            }
+            return static_cast<int>(hardest) + 1 + std::min(advanced, 99) / 100.0;
+        }
+    };
+
+    /** @brief One deduction, as made by nextStep */
+    struct Step {
+        Technique technique = Technique::Guess;
+        int cell = -1;   ///< Cell placed by a single, -1 for other techniques
+        int digit = 0;   ///< Digit placed there
+        std::vector<std::pair<int, Mask>> eliminations; ///< Cells and the candidates they lost
+        std::vector<int> support; ///< Cells the deduction follows from
+    };
+
+    /**
+     * @brief Display name of a technique
+     * @param technique Technique to name
+     * @return E.g. "Hidden Single", "X-Wing" or "Guess"
+     */
+    static const char *techniqueName(Technique technique)
+    {
+        static const char *const kNames[TECHNIQUE_COUNT] = {
+            "Naked Single", "Hidden Single", "Locked Candidates", "Naked Pair",
+            "Hidden Pair", "Naked Triple", "Hidden Triple", "X-Wing", "Swordfish",
+            "XY-Wing", "XYZ-Wing", "Simple Colouring", "XY-Chain", "Guess"
+        };
+        return kNames[static_cast<int>(technique)];
+    }
+
+    /**
+     * @brief Grades a puzzle
+     * @param givens Board with 0 for empty cells
+     * @param diagonal Whether the diagonals are units too
+     * @param limit Stop as soon as a technique harder than this is needed;
+     *        the grade then reports that technique as hardest and solved false
+     * @return The grade; hardest is Guess if logic stalls before the end
+     */
+    static Grade grade(const Cells &givens, bool diagonal, Technique limit = Technique::Guess)
+    {
+        Grade result;
+        State state;
+        if (!Engine::load(givens, state, diagonal)) {
+            result.valid = false;
+            return result;
+        }
+
+        for (;;) {
+            if (state.emptyCount == 0) {
+                result.solved = true;
+                return result;
+            }
+            if (contradiction(state, diagonal)) {
+                result.valid = false;
+                return result;
+            }
+
+            const Technique used = apply(state, diagonal, nullptr);
+            ++result.uses[static_cast<int>(used)];
+            if (used > result.hardest) {
+                result.hardest = used;
+            }
+            if (used == Technique::Guess || used > limit) {
+                return result;
+            }
+        }
+    }
+
+    /**
+     * @brief Makes the single easiest deduction available
+     *
+     * Unlike grade(), which lets singles fill every cell they can in one
+     * pass, exactly one cell is placed or one elimination pattern applied.
+     * @param state Candidate state; receives the placement or eliminations
+     * @param diagonal Whether the diagonals are units too
+     * @param step Receives the technique, the placement or the eliminations,
+     *        and the supporting cells
+     * @return False if the grid is complete or contradictory, or if no
+     *         technique applies (step.technique is then Guess)
+     */
+    static bool nextStep(State &state, bool diagonal, Step &step)
+    {
+        step = Step();
+        if (state.emptyCount == 0 || contradiction(state, diagonal)) {
+            return false;
+        }
+
+        const std::array<Mask, Engine::CELL_COUNT> before = state.candidates;
+        step.technique = apply(state, diagonal, &step);
+        if (step.technique == Technique::Guess) {
+            return false;
+        }
+        if (step.cell < 0) {
+            for (int cell = 0; cell < Engine::CELL_COUNT; ++cell) {
+                const Mask lost = static_cast<Mask>(before[cell] & ~state.candidates[cell]);
+                if (lost) {
+                    step.eliminations.push_back({cell, lost});
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    /**
+     * @brief Runs the easiest technique that makes progress
+     * @param step Null while grading; otherwise only one deduction is made
+     *        and its placement and supporting cells are recorded here
+     * @return The technique used, Guess if none applied
+     */
+    static Technique apply(State &state, bool diagonal, Step *step)
+    {
+        if (nakedSingles(state, diagonal, step)) {
+            return Technique::NakedSingle;
+        }
+        if (hiddenSingles(state, diagonal, step)) {
+            return Technique::HiddenSingle;
+        }
+        if (lockedCandidates(state, step)) {
+            return Technique::LockedCandidates;
+        }
+        if (nakedSubset(state, diagonal, 2, step)) {
+            return Technique::NakedPair;
+        }
+        if (hiddenSubset(state, diagonal, 2, step)) {
+            return Technique::HiddenPair;
+        }
+        if (nakedSubset(state, diagonal, 3, step)) {
+            return Technique::NakedTriple;
+        }
+        if (hiddenSubset(state, diagonal, 3, step)) {
+            return Technique::HiddenTriple;
+        }
+        if (fish(state, 2, step)) {
+            return Technique::XWing;
+        }
+        if (fish(state, 3, step)) {
+            return Technique::Swordfish;
+        }
+        if (xyWing(state, diagonal, step)) {
+            return Technique::XYWing;
+        }
+        if (xyzWing(state, diagonal, step)) {
+            return Technique::XYZWing;
+        }
+        if (simpleColouring(state, diagonal, step)) {
+            return Technique::SimpleColouring;
+        }
+        if (xyChain(state, diagonal, step)) {
+            return Technique::XYChain;
+        }
+        return Technique::Guess;
+    }
+
+    /** @brief Empty cell without candidates, or a unit that lost a digit */
+    static bool contradiction(const State &state, bool diagonal)
+    {
+        for (int u = 0; u < Engine::unitCount(diagonal); ++u) {
+            Mask seen = 0;
+            for (int cell : Engine::tables.units[u]) {
+                if (state.cells[cell] != 0) {
+                    seen |= Engine::bit(state.cells[cell]);
+                } else if (state.candidates[cell] == 0) {
+                    return true;
+                } else {
+                    seen |= state.candidates[cell];
+                }
+            }
+            if (seen != Engine::ALL_DIGITS) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Places every cell that has a single candidate (only the first
+     * with a step, supported by the filled cells that rule out the others)
+     */
+    static bool nakedSingles(State &state, bool diagonal, Step *step)
+    {
+        bool progress = false;
+        for (int cell = 0; cell < Engine::CELL_COUNT; ++cell) {
+            const Mask mask = state.candidates[cell];
+            if (state.cells[cell] == 0 && mask != 0 && (mask & (mask - 1)) == 0) {
+                const int num = Engine::lowestDigit(mask);
+                Engine::place(state, cell, num, diagonal);
+                progress = true;
+                if (step) {
+                    step->cell = cell;
+                    step->digit = num;
+                    step->support = blockers(state, cell, num, diagonal);
+                    return true;
+                }
+            }
+        }
+        return progress;
+    }
+
+    /** @brief One filled cell sharing a unit with cell for every digit but num */
+    static std::vector<int> blockers(const State &state, int cell, int num, bool diagonal)
+    {
+        std::vector<int> found;
+        Mask covered = Engine::bit(num);
+        for (int u : cellUnitList(cell, diagonal)) {
+            if (u < 0) {
+                continue;
+            }
+            for (int other : Engine::tables.units[u]) {
+                const int value = state.cells[other];
+                if (other != cell && value != 0 && !(covered & Engine::bit(value))) {
+                    covered |= Engine::bit(value);
+                    found.push_back(other);
+                }
+            }
+        }
+        return found;
+    }
+
+    /**
+     * @brief Places every digit that has a single cell left in some unit
+     * (only the first with a step, supported by the rest of that unit)
+     */
+    static bool hiddenSingles(State &state, bool diagonal, Step *step)
+    {
+        bool progress = false;
+        for (int u = 0; u < Engine::unitCount(diagonal); ++u) {
+            Mask once = 0;
+            Mask twice = 0;
+            for (int cell : Engine::tables.units[u]) {
+                twice |= once & state.candidates[cell];
+                once |= state.candidates[cell];
+            }
+            for (Mask hidden = once & ~twice; hidden; hidden &= hidden - 1) {
+                const int num = Engine::lowestDigit(hidden);
+                for (int cell : Engine::tables.units[u]) {
+                    if (state.candidates[cell] & Engine::bit(num)) {
+                        Engine::place(state, cell, num, diagonal);
+                        progress = true;
+                        if (step) {
+                            step->cell = cell;
+                            step->digit = num;
+                            for (int other : Engine::tables.units[u]) {
+                                if (other != cell) {
+                                    step->support.push_back(other);
+                                }
+                            }
+                            return true;
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+        return progress;
+    }
+
+    /**
+     * @brief Pointing and claiming. Without a step this is
+     * Engine::lockedCandidates, which clears every intersection at once;
+     * with one, only the first digit found is cleared, supported by the
+     * cells of the box/line segment it is locked in.
+     */
+    static bool lockedCandidates(State &state, Step *step)
+    {
+        if (!step) {
+            return Engine::lockedCandidates(state);
+        }
+
+        constexpr int S = Engine::GRID_SIZE;
+        std::vector<int> segment;
+        std::vector<int> restOfBox;
+        std::vector<int> restOfLine;
+        for (int box = 0; box < S; ++box) {
+            for (int horizontal = 0; horizontal < 2; ++horizontal) {
+                for (int k = 0; k < BoxSize; ++k) {
+                    const int line = horizontal ? (box / BoxSize) * BoxSize + k : (box % BoxSize) * BoxSize + k;
+                    for (int num = 1; num <= S; ++num) {
+                        const Mask digit = Engine::bit(num);
+                        segment.clear();
+                        restOfBox.clear();
+                        restOfLine.clear();
+                        for (int cell : Engine::tables.units[2 * S + box]) {
+                            const auto &u = Engine::tables.cellUnits[cell];
+                            if (state.candidates[cell] & digit) {
+                                ((horizontal ? u.row : u.col) == line ? segment : restOfBox).push_back(cell);
+                            }
+                        }
+                        for (int cell : Engine::tables.units[horizontal ? line : S + line]) {
+                            if ((state.candidates[cell] & digit) && Engine::tables.cellUnits[cell].box != box) {
+                                restOfLine.push_back(cell);
+                            }
+                        }
+
+                        // Pointing clears the rest of the line, claiming the rest of the box
+                        const std::vector<int> &cleared = restOfBox.empty() ? restOfLine : restOfBox;
+                        if (segment.empty() || (!restOfBox.empty() && !restOfLine.empty()) || cleared.empty()) {
+                            continue;
+                        }
+                        for (int cell : cleared) {
+                            state.candidates[cell] &= static_cast<Mask>(~digit);
+                        }
+                        step->support = segment;
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Naked pair/triple: size cells of a unit holding only size digits
+     * between them; those digits go from the unit's other cells
+     */
+    static bool nakedSubset(State &state, bool diagonal, int size, Step *step)
+    {
+        for (int u = 0; u < Engine::unitCount(diagonal); ++u) {
+            const auto &unit = Engine::tables.units[u];
+
+            // Cells small enough to be part of a subset of this size
+            std::array<int, Engine::GRID_SIZE> members{};
+            int memberCount = 0;
+            for (int j = 0; j < Engine::GRID_SIZE; ++j) {
+                const int options = Engine::count(state.candidates[unit[j]]);
+                if (options >= 2 && options <= size) {
+                    members[memberCount++] = j;
+                }
+            }
+
+            std::array<int, 3> pick{};
+            if (chooseSubset(memberCount, size, pick, [&](const std::array<int, 3> &chosen) {
+                    Mask digits = 0;
+                    std::uint32_t inSubset = 0; // Bitmask over unit positions
+                    for (int k = 0; k < size; ++k) {
+                        digits |= state.candidates[unit[members[chosen[k]]]];
+                        inSubset |= std::uint32_t(1) << members[chosen[k]];
+                    }
+                    if (Engine::count(digits) != size) {
+                        return false;
+                    }
+                    bool removed = false;
+                    for (int j = 0; j < Engine::GRID_SIZE; ++j) {
+                        Mask &mask = state.candidates[unit[j]];
+                        if (!(inSubset & (std::uint32_t(1) << j)) && (mask & digits)) {
+                            mask &= static_cast<Mask>(~digits);
+                            removed = true;
+                        }
+                    }
+                    if (removed && step) {
+                        step->support = unitCells(unit, inSubset);
+                    }
+                    return removed;
+                })) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Hidden pair/triple: size digits confined to the same size cells
+     * of a unit; those cells lose every other candidate
+     */
+    static bool hiddenSubset(State &state, bool diagonal, int size, Step *step)
+    {
+        for (int u = 0; u < Engine::unitCount(diagonal); ++u) {
+            const auto &unit = Engine::tables.units[u];
+
+            // Positions of each digit within the unit, for digits seen in 2..size cells
+            std::array<int, Engine::GRID_SIZE> digits{};
+            std::array<std::uint32_t, Engine::GRID_SIZE> positions{};
+            int digitCount = 0;
+            for (int num = 1; num <= Engine::GRID_SIZE; ++num) {
+                std::uint32_t where = 0;
+                for (int j = 0; j < Engine::GRID_SIZE; ++j) {
+                    if (state.candidates[unit[j]] & Engine::bit(num)) {
+                        where |= std::uint32_t(1) << j;
+                    }
+                }
+                const int cells = static_cast<int>(qPopulationCount(where));
+                if (cells >= 2 && cells <= size) {
+                    digits[digitCount] = num;
+                    positions[digitCount++] = where;
+                }
+            }
+
+            std::array<int, 3> pick{};
+            if (chooseSubset(digitCount, size, pick, [&](const std::array<int, 3> &chosen) {
+                    std::uint32_t where = 0;
+                    Mask keep = 0;
+                    for (int k = 0; k < size; ++k) {
+                        where |= positions[chosen[k]];
+                        keep |= Engine::bit(digits[chosen[k]]);
+                    }
+                    if (static_cast<int>(qPopulationCount(where)) != size) {
+                        return false;
+                    }
+                    bool removed = false;
+                    for (int j = 0; j < Engine::GRID_SIZE; ++j) {
+                        Mask &mask = state.candidates[unit[j]];
+                        if ((where & (std::uint32_t(1) << j)) && (mask & ~keep)) {
+                            mask &= keep;
+                            removed = true;
+                        }
+                    }
+                    if (removed && step) {
+                        step->support = unitCells(unit, where);
+                    }
+                    return removed;
+                })) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Fish of size 2 (X-Wing) or 3 (Swordfish): a digit whose places
+     * in size rows all fall in the same size columns leaves those columns
+     * everywhere else (and transposed)
+     */
+    static bool fish(State &state, int size, Step *step)
+    {
+        constexpr int S = Engine::GRID_SIZE;
+        for (int num = 1; num <= S; ++num) {
+            const Mask digit = Engine::bit(num);
+            for (int byRow = 0; byRow < 2; ++byRow) {
+                // Cross positions of the digit in each line that can be part of a fish
+                std::array<int, S> lines{};
+                std::array<std::uint32_t, S> where{};
+                int lineCount = 0;
+                for (int line = 0; line < S; ++line) {
+                    std::uint32_t mask = 0;
+                    for (int cross = 0; cross < S; ++cross) {
+                        const int cell = byRow ? line * S + cross : cross * S + line;
+                        if (state.candidates[cell] & digit) {
+                            mask |= std::uint32_t(1) << cross;
+                        }
+                    }
+                    const int places = static_cast<int>(qPopulationCount(mask));
+                    if (places >= 2 && places <= size) {
+                        lines[lineCount] = line;
+                        where[lineCount++] = mask;
+                    }
+                }
+
+                std::array<int, 3> pick{};
+                if (chooseSubset(lineCount, size, pick, [&](const std::array<int, 3> &chosen) {
+                        std::uint32_t crosses = 0;
+                        std::uint32_t baseLines = 0;
+                        for (int k = 0; k < size; ++k) {
+                            crosses |= where[chosen[k]];
+                            baseLines |= std::uint32_t(1) << lines[chosen[k]];
+                        }
+                        if (static_cast<int>(qPopulationCount(crosses)) != size) {
+                            return false;
+                        }
+                        bool removed = false;
+                        for (int line = 0; line < S; ++line) {
+                            if (baseLines & (std::uint32_t(1) << line)) {
+                                continue;
+                            }
+                            for (std::uint32_t m = crosses; m; m &= m - 1) {
+                                const int cross = static_cast<int>(qCountTrailingZeroBits(m));
+                                const int cell = byRow ? line * S + cross : cross * S + line;
+                                if (state.candidates[cell] & digit) {
+                                    state.candidates[cell] &= static_cast<Mask>(~digit);
+                                    removed = true;
+                                }
+                            }
+                        }
+                        if (removed && step) {
+                            // The digit's places in the base lines
+                            step->support.clear();
+                            for (int k = 0; k < size; ++k) {
+                                for (std::uint32_t m = where[chosen[k]]; m; m &= m - 1) {
+                                    const int cross = static_cast<int>(qCountTrailingZeroBits(m));
+                                    const int line = lines[chosen[k]];
+                                    step->support.push_back(byRow ? line * S + cross : cross * S + line);
+                                }
+                            }
+                        }
+                        return removed;
+                    })) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /** @brief Whether two different cells share a unit */
+    static bool sees(int a, int b, bool diagonal)
+    {
+        const auto &ua = Engine::tables.cellUnits[a];
+        const auto &ub = Engine::tables.cellUnits[b];
+        return a != b && (ua.row == ub.row || ua.col == ub.col || ua.box == ub.box ||
+                          (diagonal && ((ua.onMainDiagonal && ub.onMainDiagonal) ||
+                                        (ua.onAntiDiagonal && ub.onAntiDiagonal))));
+    }
+
+    /**
+     * @brief Removes a digit from every cell that sees all of the given cells
+     * @return True if any candidate was removed
+     */
+    static bool eliminateSeenByAll(State &state, Mask digit, std::initializer_list<int> cells, bool diagonal)
+    {
+        bool removed = false;
+        for (int cell = 0; cell < Engine::CELL_COUNT; ++cell) {
+            if (!(state.candidates[cell] & digit)) {
+                continue;
+            }
+            bool seesAll = true;
+            for (int other : cells) {
+                seesAll = seesAll && sees(cell, other, diagonal);
+            }
+            if (seesAll) {
+                state.candidates[cell] &= static_cast<Mask>(~digit);
+                removed = true;
+            }
+        }
+        return removed;
+    }
+
+    /**
+     * @brief XY-Wing: a pivot {x,y} seeing pincers {x,z} and {y,z}; one
+     * pincer is z either way, so z goes from cells seeing both pincers
+     */
+    static bool xyWing(State &state, bool diagonal, Step *step)
+    {
+        for (int pivot = 0; pivot < Engine::CELL_COUNT; ++pivot) {
+            const Mask xy = state.candidates[pivot];
+            if (Engine::count(xy) != 2) {
+                continue;
+            }
+            for (int a = 0; a < Engine::CELL_COUNT; ++a) {
+                const Mask xz = state.candidates[a];
+                if (Engine::count(xz) != 2 || Engine::count(xz & xy) != 1 || !sees(pivot, a, diagonal)) {
+                    continue;
+                }
+                const Mask z = xz & static_cast<Mask>(~xy);
+                const Mask yz = static_cast<Mask>((xy & ~xz) | z);
+                for (int b = a + 1; b < Engine::CELL_COUNT; ++b) {
+                    if (state.candidates[b] == yz && sees(pivot, b, diagonal) &&
+                        eliminateSeenByAll(state, z, {a, b}, diagonal)) {
+                        if (step) {
+                            step->support = {pivot, a, b};
+                        }
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief XYZ-Wing: a pivot {x,y,z} seeing pincers {x,z} and {y,z}; z
+     * goes from cells seeing the pivot and both pincers
+     */
+    static bool xyzWing(State &state, bool diagonal, Step *step)
+    {
+        for (int pivot = 0; pivot < Engine::CELL_COUNT; ++pivot) {
+            const Mask xyz = state.candidates[pivot];
+            if (Engine::count(xyz) != 3) {
+                continue;
+            }
+            for (int a = 0; a < Engine::CELL_COUNT; ++a) {
+                const Mask xz = state.candidates[a];
+                if (Engine::count(xz) != 2 || (xz & ~xyz) || !sees(pivot, a, diagonal)) {
+                    continue;
+                }
+                for (int b = a + 1; b < Engine::CELL_COUNT; ++b) {
+                    const Mask yz = state.candidates[b];
+                    if (Engine::count(yz) != 2 || (yz & ~xyz) || yz == xz || !sees(pivot, b, diagonal)) {
+                        continue;
+                    }
+                    if (eliminateSeenByAll(state, xz & yz, {pivot, a, b}, diagonal)) {
+                        if (step) {
+                            step->support = {pivot, a, b};
+                        }
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Simple colouring: the cells of a digit linked by conjugate
+     * pairs (the only two places in a unit) alternate between two colours,
+     * exactly one of which is true. Two cells of one colour seeing each
+     * other make that colour false (wrap); a cell seeing both colours
+     * loses the digit (trap).
+     */
+    static bool simpleColouring(State &state, bool diagonal, Step *step)
+    {
+        const int unitCount = Engine::unitCount(diagonal);
+        for (int num = 1; num <= Engine::GRID_SIZE; ++num) {
+            const Mask digit = Engine::bit(num);
+
+            // Units where the digit is a conjugate pair
+            std::array<std::uint8_t, Engine::DIAGONAL_UNIT_COUNT> places{};
+            for (int u = 0; u < unitCount; ++u) {
+                for (int cell : Engine::tables.units[u]) {
+                    places[u] += (state.candidates[cell] & digit) ? 1 : 0;
+                }
+            }
+
+            std::array<std::int8_t, Engine::CELL_COUNT> colour;
+            colour.fill(-1);
+            std::vector<int> component;
+            for (int start = 0; start < Engine::CELL_COUNT; ++start) {
+                if (colour[start] >= 0 || !(state.candidates[start] & digit)) {
+                    continue;
+                }
+
+                // Colour the chain through start, breadth first
+                component.assign(1, start);
+                colour[start] = 0;
+                for (std::size_t next = 0; next < component.size(); ++next) {
+                    const int cell = component[next];
+                    for (int u : cellUnitList(cell, diagonal)) {
+                        if (u < 0 || places[u] != 2) {
+                            continue;
+                        }
+                        for (int other : Engine::tables.units[u]) {
+                            if (other != cell && (state.candidates[other] & digit) && colour[other] < 0) {
+                                colour[other] = static_cast<std::int8_t>(1 - colour[cell]);
+                                component.push_back(other);
+                            }
+                        }
+                    }
+                }
+                if (component.size() < 2) {
+                    continue;
+                }
+
+                // Wrap: a colour that contradicts itself is false everywhere
+                for (int c = 0; c < 2; ++c) {
+                    bool wrap = false;
+                    for (std::size_t i = 0; i < component.size() && !wrap; ++i) {
+                        for (std::size_t j = i + 1; j < component.size() && !wrap; ++j) {
+                            wrap = colour[component[i]] == c && colour[component[j]] == c &&
+                                   sees(component[i], component[j], diagonal);
+                        }
+                    }
+                    if (wrap) {
+                        for (int cell : component) {
+                            if (colour[cell] == c) {
+                                state.candidates[cell] &= static_cast<Mask>(~digit);
+                            }
+                        }
+                        if (step) {
+                            step->support = component;
+                        }
+                        return true;
+                    }
+                }
+
+                // Trap: an uncoloured cell seeing both colours
+                bool removed = false;
+                for (int cell = 0; cell < Engine::CELL_COUNT; ++cell) {
+                    if (!(state.candidates[cell] & digit) || colour[cell] >= 0) {
+                        continue;
+                    }
+                    bool seen[2] = {false, false};
+                    for (int other : component) {
+                        if (sees(cell, other, diagonal)) {
+                            seen[colour[other]] = true;
+                        }
+                    }
+                    if (seen[0] && seen[1]) {
+                        state.candidates[cell] &= static_cast<Mask>(~digit);
+                        removed = true;
+                    }
+                }
+                if (removed) {
+                    if (step) {
+                        step->support = component;
+                    }
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief XY-Chain: bivalue cells linked by shared digits, starting and
+     * ending on z. If the first cell is not z, the chain forces the last one
+     * to be z, so z goes from cells seeing both ends.
+     */
+    static bool xyChain(State &state, bool diagonal, Step *step)
+    {
+        std::vector<int> bivalue;
+        for (int cell = 0; cell < Engine::CELL_COUNT; ++cell) {
+            if (Engine::count(state.candidates[cell]) == 2) {
+                bivalue.push_back(cell);
+            }
+        }
+
+        std::array<Mask, Engine::CELL_COUNT> reached{}; // Forced values seen per cell
+        std::vector<std::pair<int, Mask>> queue;
+        std::vector<int> from; // Queue index each entry was reached from
+        for (int start : bivalue) {
+            for (Mask zs = state.candidates[start]; zs; zs &= zs - 1) {
+                const Mask z = zs & static_cast<Mask>(~(zs - 1));
+
+                // Breadth first over (cell, value forced if start is not z)
+                reached.fill(0);
+                queue.assign(1, {start, static_cast<Mask>(state.candidates[start] & ~z)});
+                from.assign(1, -1);
+                reached[start] = queue.front().second;
+                for (std::size_t next = 0; next < queue.size(); ++next) {
+                    const int cell = queue[next].first;
+                    const Mask value = queue[next].second;
+                    for (int link : bivalue) {
+                        if (!(state.candidates[link] & value) || !sees(cell, link, diagonal)) {
+                            continue;
+                        }
+                        const Mask forced = static_cast<Mask>(state.candidates[link] & ~value);
+                        if (reached[link] & forced) {
+                            continue;
+                        }
+                        reached[link] |= forced;
+                        if (forced == z && link != start &&
+                            eliminateSeenByAll(state, z, {start, link}, diagonal)) {
+                            if (step) {
+                                step->support.assign(1, link);
+                                for (int at = static_cast<int>(next); at >= 0; at = from[at]) {
+                                    step->support.push_back(queue[at].first);
+                                }
+                            }
+                            return true;
+                        }
+                        queue.push_back({link, forced});
+                        from.push_back(static_cast<int>(next));
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    /** @brief Cells at the given positions (bitmask) of a unit */
+    template <typename Unit>
+    static std::vector<int> unitCells(const Unit &unit, std::uint32_t positions)
+    {
+        std::vector<int> cells;
+        for (std::uint32_t m = positions; m; m &= m - 1) {
+            cells.push_back(unit[qCountTrailingZeroBits(m)]);
+        }
+        return cells;
+    }
+
+    /** @brief Units of a cell; -1 for diagonals it is not on */
+    static std::array<int, 5> cellUnitList(int cell, bool diagonal)
+    {
+        const auto &u = Engine::tables.cellUnits[cell];
+        constexpr int S = Engine::GRID_SIZE;
+        return {u.row, S + u.col, 2 * S + u.box,
+                diagonal && u.onMainDiagonal ? Engine::MAIN_DIAGONAL_UNIT : -1,
+                diagonal && u.onAntiDiagonal ? Engine::ANTI_DIAGONAL_UNIT : -1};
+    }
+
+    /**
+     * @brief Calls visit with each size-element combination of 0..n-1 (size
+     * 2 or 3) until it returns true
+     * @return True if visit returned true
+     */
+    template <typename Visit>
+    static bool chooseSubset(int n, int size, std::array<int, 3> &pick, Visit &&visit)
+    {
+        for (pick[0] = 0; pick[0] < n; ++pick[0]) {
+            for (pick[1] = pick[0] + 1; pick[1] < n; ++pick[1]) {
+                if (size == 2) {
+                    if (visit(pick)) {
+                        return true;
+                    }
+                    continue;
+                }
+                for (pick[2] = pick[1] + 1; pick[2] < n; ++pick[2]) {
+                    if (visit(pick)) {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+};
+
+#endif // SUDOKUGRADER_H
@@ -0,0 +1,147 @@
+/**
+ * @file WorkStealingPool.cpp
+ * @brief Implementation of the WorkStealingPool class
+ */
+
+#include "WorkStealingPool.h"
+
+namespace {
+
+// Index of the pool worker running on this thread, -1 elsewhere
+thread_local const WorkStealingPool *tlsPool = nullptr;
+thread_local int tlsWorkerIndex = -1;
+
+} // namespace
+
+/**
+ * Constructor for WorkStealingPool
+ * Creates one deque per worker and starts the threads
+ */
+WorkStealingPool::WorkStealingPool(int threads)
+    : m_queued(0),
+      m_pending(0),
+      m_nextQueue(0),
+      m_stopping(false)
+{
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    if (threads <= 0) {
+        threads = 1;
+    }
+
+    for (int i = 0; i < threads; ++i) {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+    m_workers.reserve(threads);
+    for (int i = 0; i < threads; ++i) {
+        m_workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+/**
+ * Destructor for WorkStealingPool
+ * Drains the queues before stopping so no submitted task is lost
+ */
+WorkStealingPool::~WorkStealingPool()
+{
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (std::thread &worker : m_workers) {
+        worker.join();
+    }
+}
+
+/**
+ * Queues a task on the calling worker's own deque, or round-robin when
+ * called from outside the pool
+ */
+void WorkStealingPool::submit(Task task)
+{
+    int index = (tlsPool == this) ? tlsWorkerIndex : -1;
+    if (index < 0) {
+        index = static_cast<int>(m_nextQueue++ % m_queues.size());
+    }
+
+    m_pending.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+        m_queues[index]->tasks.push_back(std::move(task));
+    }
+    m_queued.fetch_add(1);
+
+    // Taking the sleep lock orders this wake-up after any worker's predicate check
+    { std::lock_guard<std::mutex> lock(m_sleepMutex); }
+    m_wake.notify_one();
+}
+
+/**
+ * Waits for the pending counter to reach zero
+ */
+void WorkStealingPool::wait()
+{
+    std::unique_lock<std::mutex> lock(m_sleepMutex);
+    m_idle.wait(lock, [this]() { return m_pending.load() == 0; });
+}
+
+/**
+ * Pops LIFO from the worker's own deque, otherwise steals FIFO from the others
+ */
+bool WorkStealingPool::takeTask(int index, Task &task)
+{
+    {
+        Queue &own = *m_queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            m_queued.fetch_sub(1);
+            return true;
+        }
+    }
+
+    const int count = static_cast<int>(m_queues.size());
+    for (int offset = 1; offset < count; ++offset) {
+        Queue &victim = *m_queues[(index + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            m_queued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Worker main loop
+ * Runs tasks until shutdown, sleeping only when no deque has work
+ */
+void WorkStealingPool::workerLoop(int index)
+{
+    tlsPool = this;
+    tlsWorkerIndex = index;
+
+    for (;;) {
+        Task task;
+        if (takeTask(index, task)) {
+            task();
+            if (m_pending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(m_sleepMutex);
+                m_idle.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wake.wait(lock, [this]() { return m_stopping || m_queued.load() > 0; });
+        if (m_stopping && m_queued.load() == 0) {
+            return;
+        }
+    }
+}
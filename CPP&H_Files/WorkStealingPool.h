@@ -0,0 +1,104 @@
+/**
+ * @file WorkStealingPool.h
+ * @brief Header file for the WorkStealingPool class, a small task scheduler
+ *
+ * This class is responsible for:
+ * - Running submitted tasks on a fixed set of worker threads
+ * - Keeping one task deque per worker so workers mostly touch their own queue
+ * - Letting idle workers steal from the other end of busy workers' deques
+ */
+
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class WorkStealingPool
+ * @brief Fixed-size thread pool with per-worker deques and stealing
+ *
+ * Tasks submitted from inside a worker go to the back of that worker's own
+ * deque and are popped LIFO (good locality for recursive splitting). Tasks
+ * submitted from outside are dealt round-robin. An idle worker steals FIFO
+ * from the front of another worker's deque, which tends to grab the largest
+ * remaining pieces of work.
+ */
+class WorkStealingPool
+{
+public:
+    /** @brief Unit of work */
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Starts the workers
+     * @param threads Number of worker threads (0 or less: hardware concurrency)
+     */
+    explicit WorkStealingPool(int threads = 0);
+
+    /**
+     * @brief Waits for all queued tasks to finish, then joins the workers
+     */
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    /**
+     * @brief Queues a task; safe to call from any thread, including workers
+     * @param task Work to run
+     */
+    void submit(Task task);
+
+    /**
+     * @brief Blocks until every submitted task (and anything they submit) is done
+     *
+     * Must not be called from a worker of this pool.
+     */
+    void wait();
+
+    /**
+     * @brief Number of worker threads
+     */
+    int threadCount() const { return static_cast<int>(m_workers.size()); }
+
+private:
+    /** @brief One worker's deque and the lock guarding it */
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /**
+     * @brief Worker main loop: own deque first, then steal, then sleep
+     * @param index Worker index
+     */
+    void workerLoop(int index);
+
+    /**
+     * @brief Takes a task for a worker
+     * @param index Worker index
+     * @param task Receives the task
+     * @return False if every deque is empty
+     */
+    bool takeTask(int index, Task &task);
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;   ///< Signalled when work is queued or on shutdown
+    std::condition_variable m_idle;   ///< Signalled when m_pending drops to zero
+    std::atomic<long> m_queued;       ///< Tasks sitting in deques
+    std::atomic<long> m_pending;      ///< Tasks submitted but not yet finished
+    std::atomic<unsigned> m_nextQueue; ///< Round-robin cursor for outside submits
+    bool m_stopping;
+};
+
+#endif // WORKSTEALINGPOOL_H
@@ -0,0 +1,96 @@
+/**
+ * @file Xoshiro256.h
+ * @brief Small, fast, seedable pseudo-random generator (xoshiro256**)
+ *
+ * This header is responsible for:
+ * - Producing a reproducible stream of 64-bit values from a 64-bit seed
+ * - Satisfying UniformRandomBitGenerator, so it can drive the engine's
+ *   shuffles and the standard distributions
+ */
+
+#ifndef XOSHIRO256_H
+#define XOSHIRO256_H
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @class Xoshiro256
+ * @brief xoshiro256** by Blackman and Vigna, seeded through SplitMix64
+ *
+ * The state is four 64-bit words and one step is a handful of shifts,
+ * rotations and multiplies, so copying and seeding are free compared with
+ * std::mt19937. The same seed gives the same stream on every platform and
+ * compiler, which is what makes puzzles reproducible from their seed.
+ * Not cryptographically secure.
+ */
+class Xoshiro256
+{
+public:
+    using result_type = std::uint64_t;
+
+    /**
+     * @brief Seeds the generator
+     * @param seed Any value; SplitMix64 spreads it over the whole state,
+     *        so nearby seeds still give unrelated streams
+     */
+    explicit Xoshiro256(std::uint64_t seed = 0) { reseed(seed); }
+
+    /**
+     * @brief Restarts the stream from a seed
+     * @param seed Any value
+     */
+    void reseed(std::uint64_t seed)
+    {
+        for (std::uint64_t &word : m_state) {
+            seed += 0x9e3779b97f4a7c15ULL;
+            std::uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    /** @brief Next value of the stream */
+    result_type operator()()
+    {
+        const std::uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+        const std::uint64_t t = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+        return result;
+    }
+
+    /**
+     * @brief Value in [0, bound) without modulo bias (Lemire's method)
+     * @param bound Exclusive upper limit, at least 1
+     */
+    std::uint32_t bounded(std::uint32_t bound)
+    {
+        std::uint64_t product = (operator()() >> 32) * bound;
+        std::uint32_t low = static_cast<std::uint32_t>(product);
+        if (low < bound) {
+            const std::uint32_t threshold = static_cast<std::uint32_t>(-bound) % bound;
+            while (low < threshold) {
+                product = (operator()() >> 32) * bound;
+                low = static_cast<std::uint32_t>(product);
+            }
+        }
+        return static_cast<std::uint32_t>(product >> 32);
+    }
+
+private:
+    static constexpr std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    std::array<std::uint64_t, 4> m_state{};
+};
+
+#endif // XOSHIRO256_H
@@ -3,18 +3,35 @@
  * @brief Main entry point for the Sudoku application
  * 
  * This file initializes the Qt application, registers C++ classes with QML,
- * and loads the main QML interface.
+ * and loads the main QML interface. When started with --solve-batch or
+ * --grade-batch it runs the headless bulk solver or grader instead, and
+ * with --benchmark the performance suite; none of them creates the GUI
+ * application.
  */
 
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
+#include "Board.h"
+#include "BoardModel.h"
 #include "SudokuGenerator.h"
 #include "Solver.h"
 #include "HistoryRead.h"
+#include "HistoryModel.h"
+#include "HistoryWriter.h"
+#include "BatchSolver.h"
+#include "Benchmark.h"
 
 int main(int argc, char *argv[])
 {
+    // Headless batch mode: no QGuiApplication, no QML engine
+    if (BatchSolver::requested(argc, argv)) {
+        return BatchSolver::runFromCommandLine(argc, argv);
+    }
+    if (Benchmark::requested(argc, argv)) {
+        return Benchmark::runFromCommandLine(argc, argv);
+    }
+
     // Enable high DPI scaling for Qt versions before 6.0
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     QCoreApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
@@ -26,11 +43,21 @@ int main(int argc, char *argv[])
     // Create the QML engine
     QQmlApplicationEngine engine;
     
-    // Register C++ classes with QML
+    // Register C++ classes with QML; Board is a value type, so only its metatype
+    qRegisterMetaType<Board>("Board");
     qmlRegisterType<SudokuGenerator>("com.sudoku.generator", 1, 0, "SudokuGenerator");
     qmlRegisterType<Solver>("com.sudoku.solver", 1, 0, "Solver");
     qmlRegisterType<HistoryRead>("com.sudoku.history", 1, 0, "HistoryRead");
+    qmlRegisterType<HistoryModel>("com.sudoku.history", 1, 0, "HistoryModel");
+    qmlRegisterType<BoardModel>("com.sudoku.board", 1, 0, "BoardModel");
     
+    // Finished games are written in the background; write the last of them before exiting
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, []() {
+        if (HistoryWriter *writer = HistoryWriter::defaultStoreIfStarted()) {
+            writer->flush();
+        }
+    });
+
     // Load the main QML file
     const QUrl url(QStringLiteral("qrc:/main.qml"));
     
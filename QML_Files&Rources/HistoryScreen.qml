@@ -2,23 +2,19 @@
  * HistoryScreen.qml
  *
  * A screen that displays the history of completed Sudoku puzzles.
- * Uses the HistoryRead C++ class to retrieve puzzle history.
+ * Shows historyModel from main.qml, a HistoryModel that hands the list its
+ * entries a page at a time, decodes only the rows it shows and follows new
+ * entries as they are saved.
  */
 
 import QtQuick 2.15
 import QtQuick.Controls 2.15
-import com.sudoku.history 1.0
 
 Item {
     id: historyScreen
     width: parent.width
     height: parent.height
 
-    // History reader component
-    HistoryRead {
-        id: historyReader
-    }
-
     Text{
         id:noHistory
         text:"Solve atleast one puzzle"
@@ -63,11 +59,7 @@ Item {
             anchors.fill: parent
             spacing: 20
             clip: true  // Important for performance with many items
-
-            // Load history data only once when the component is created
-            Component.onCompleted: {
-                model = historyReader.getHistory();
-            }
+            model: historyModel
 
             // Invisible scrollbar for better performance
             ScrollBar.vertical: ScrollBar {
@@ -93,7 +85,7 @@ Item {
                 contentItem: Text {
                     // Format difficulty text once instead of using conditional operators in the binding
                     readonly property string difficultyText: {
-                        switch(modelData.difficulty) {
+                        switch(model.difficulty) {
                             case 1: return "Easy";
                             case 2: return "Medium";
                             case 3: return "Hard";
@@ -101,7 +93,7 @@ Item {
                         }
                     }
 
-                    text: "Date: " + modelData.date + " - Time: " + modelData.time + "s (Difficulty: " + difficultyText + ")"
+                    text: "Date: " + model.date + " - Time: " + model.time + "s (Difficulty: " + difficultyText + ")"
                     color: mainWindow.textMainColour
                     font.pixelSize: 16
                     elide: Text.ElideRight
@@ -115,10 +107,10 @@ Item {
                 // Navigate to puzzle detail view when clicked
                 onClicked: {
                     stackView.push("PuzzleHistoryView.qml", {
-                        date: modelData.date,
-                        time: modelData.time,
-                        difficulty: modelData.difficulty,
-                        gridString: JSON.stringify(modelData.grid)
+                        date: model.date,
+                        time: model.time,
+                        difficulty: model.difficulty,
+                        board: model.grid
                     })
                 }
             }
@@ -10,6 +10,7 @@ import QtQuick.Window
 import QtQuick.Controls
 import QtQuick.Controls.Fusion
 import QtMultimedia
+import com.sudoku.history 1.0
 
 ApplicationWindow {
     id: mainWindow
@@ -50,6 +51,12 @@ ApplicationWindow {
     // Handle menu visibility changes
     onMenuColumnVisibleChanged: menuColumnAnim.start()
 
+    // Puzzle history, kept for the whole session so HistoryScreen only
+    // picks up entries appended since its last visit
+    HistoryModel {
+        id: historyModel
+    }
+
     // Background music player
     MediaPlayer {
         id: playerMusic
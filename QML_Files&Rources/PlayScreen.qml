@@ -9,6 +9,7 @@ import QtQuick 2.15
 import QtQuick.Controls 2.15
 import QtQuick.Layouts 1.15
 import com.sudoku.generator 1.0
+import com.sudoku.board 1.0
 
 Item {
     id: sudokuGameScreen
@@ -20,9 +21,10 @@ Item {
     property int selectedNumber: 0 // Currently selected number for input
     property bool gameStarted: false
     property int difficulty: 1 // 1: Easy, 2: Medium, 3: Hard
-    property var sudokuPuzzle: [] // Stores the current puzzle
     property bool isPlayScreenLoaded: false
     property bool startButtonShowing: true
+    property var hintCells: [] // Cells the last hint is about
+    property var hintSupport: [] // Cells the last hint follows from
 
     // Initialize the screen
     Component.onCompleted: {
@@ -40,49 +42,26 @@ Item {
         }
     }
 
+    // Cell values, givens and correctness of the game in progress
+    BoardModel {
+        id: board
+    }
+
     // Sudoku generator component
     SudokuGenerator {
         id: sudokuGenerator
         
         // Handle newly generated puzzles
-        onSudokuGenerated: function(puzzle) {
-            sudokuPuzzle = puzzle
-            // Populate the grid with the generated puzzle
-            for (var i = 0; i < 9; ++i) {
-                for (var j = 0; j < 9; ++j) {
-                    var cellIndex = i * 9 + j;
-                    var cellItem = sudokuCellsRepeater.itemAt(cellIndex);
-                    var cellInput = cellItem.children[0];
-                    var value = sudokuPuzzle[i][j];
-                    if (value !== 0) {
-                        cellInput.text = value.toString();
-                        cellItem.isGiven = true;
-                    } else {
-                        cellInput.text = "";
-                        cellItem.isGiven = false;
-                    }
-                }
-            }
+        onPuzzleGenerated: function(puzzle) {
+            clearHint()
+            board.loadPuzzle(puzzle)
         }
         
         // Handle puzzle check results
         onPuzzleChecked: function(status) {
             if (status === 1) { // Correct
-                // Get current grid state
-                var currentGrid = [];
-                for (var i = 0; i < 9; i++) {
-                    var row = [];
-                    for (var j = 0; j < 9; j++) {
-                        var cellIndex = i * 9 + j;
-                        var cellItem = sudokuCellsRepeater.itemAt(cellIndex);
-                        var cellInput = cellItem.children[0];
-                        row.push(cellInput.text === "" ? 0 : parseInt(cellInput.text));
-                    }
-                    currentGrid.push(row);
-                }
-                
                 // Save the completed puzzle
-                sudokuGenerator.savePuzzle(currentGrid, mainWindow.gameTimer.seconds, difficulty);
+                sudokuGenerator.saveBoard(board, mainWindow.gameTimer.seconds, difficulty);
                 
                 // Show success popup
                 popup.popupTitle = "Congratulations!";
@@ -231,60 +210,76 @@ Item {
             spacing: 0
             anchors.fill: parent
 
-            // Generate 81 cells (9x9)
+            // One cell per board model row (9x9)
             Repeater {
                 id: sudokuCellsRepeater
-                model: 81
+                model: board
                 
                 // Individual cell
                 Rectangle {
                     width: sudokuGrid.width / 9
                     height: sudokuGrid.height / 9
-                    color: "transparent"
+                    color: hintCells.indexOf(index) >= 0 ? "#60228201"
+                                              : (hintSupport.indexOf(index) >= 0 ? "#30228201" : "transparent")
                     border.width: 1
                     border.color: mainWindow.borderMainColour
 
-                    property bool isGiven: false
-                    property bool isCorrect: false
-
-                    // Cell input field
+                    // Cell input field, showing the model's value
                     TextInput {
                         id: cellInput
                         anchors.fill: parent
                         horizontalAlignment: Text.AlignHCenter
                         verticalAlignment: Text.AlignVCenter
                         font.pixelSize: 20
-                        color: isGiven ? "lightgray" : (isCorrect ? "blue" : "white")
-                        readOnly: isGiven
+                        text: model.value === 0 ? "" : model.value.toString()
+                        color: model.given ? "lightgray" : (model.correct ? "blue" : "red")
+                        readOnly: model.given
                         validator: IntValidator { bottom: 1; top: 9; }
 
                         onAccepted: {
                             var num = parseInt(text, 10);
                             if (!isNaN(num)) {
-                                var row = Math.floor(index / 9);
-                                var col = index % 9;
-                                isCorrect = sudokuGenerator.checkNumber(row, col, num);
-                                if (!isCorrect) {
-                                    text = "";
+                                clearHint();
+                                if (!sudokuGenerator.enterNumber(board, index, num)) {
+                                    board.setValue(index, 0);
                                 }
                             }
+                            // Typing replaced the binding; follow the model again
+                            text = Qt.binding(function() { return model.value === 0 ? "" : model.value.toString(); });
                             parent.focus = false;
                         }
                     }
 
-                    // Cell click handler
+                    // Pencil marks of an empty cell
+                    Text {
+                        anchors.fill: parent
+                        anchors.margins: 2
+                        visible: model.value === 0 && model.notes !== 0
+                        text: {
+                            var digits = "";
+                            for (var d = 1; d <= 9; d++) {
+                                if (model.notes & (1 << (d - 1))) {
+                                    digits += d;
+                                }
+                            }
+                            return digits;
+                        }
+                        color: mainWindow.textMainColour
+                        font.pixelSize: 9
+                        wrapMode: Text.WrapAnywhere
+                    }
+
+                    // Cell click handler: left enters the selected number, right toggles it as a pencil mark
                     MouseArea {
                         anchors.fill: parent
-                        onClicked: {
-                            if (sudokuGameScreen.gameStarted && !isGiven && selectedNumber !== 0) {
-                                cellInput.text = selectedNumber.toString();
-                                var row = Math.floor(index / 9);
-                                var col = index % 9;
-                                isCorrect = sudokuGenerator.checkNumber(row, col, selectedNumber);
-                                if (!isCorrect) {
-                                    cellInput.color = "red"; // Indicate incorrect input
+                        acceptedButtons: Qt.LeftButton | Qt.RightButton
+                        onClicked: function(mouse) {
+                            if (sudokuGameScreen.gameStarted && !model.given && selectedNumber !== 0) {
+                                clearHint();
+                                if (mouse.button === Qt.RightButton) {
+                                    board.toggleNote(index, selectedNumber);
                                 } else {
-                                    cellInput.color = "blue"; // Indicate correct input
+                                    sudokuGenerator.enterNumber(board, index, selectedNumber);
                                 }
                             }
                         }
@@ -323,7 +318,7 @@ Item {
             onPressed: startButton.color = "#60228201"
             onReleased: startButton.color = "transparent"
             onClicked: {
-                sudokuGenerator.generateSudoku(difficulty);
+                sudokuGenerator.generateBoard(difficulty);
                 mainWindow.gameTimer.running = true;
                 mainWindow.gameTimer.seconds = 0;
                 sudokuGameScreen.gameStarted = true;
@@ -360,20 +355,65 @@ Item {
             cursorShape: Qt.BlankCursor
             onPressed: finishButton.color = "#60228201"
             onReleased: finishButton.color = "transparent"
+            onClicked: sudokuGenerator.checkBoard(board)
+        }
+    }
+
+    // Hint button
+    Rectangle {
+        id: hintButton
+        width: 100
+        height: 40
+        color: "transparent"
+        radius: 5
+        border.width: 2
+        border.color: mainWindow.borderMainColour
+        visible: sudokuGameScreen.gameStarted
+        anchors.bottom: borderControl.bottom
+        anchors.bottomMargin: 120
+        anchors.right: parent.right
+        anchors.rightMargin: 60
+
+        Text {
+            text: "HINT"
+            color: mainWindow.textMainColour
+            anchors.centerIn: parent
+            font.pixelSize: 15
+        }
+
+        MouseArea {
+            anchors.fill: parent
+            hoverEnabled: true
+            cursorShape: Qt.BlankCursor
+            onPressed: hintButton.color = "#60228201"
+            onReleased: hintButton.color = "transparent"
             onClicked: {
-                // Collect current grid state
-                var currentGrid = [];
-                for (var i = 0; i < 9; i++) {
-                    var row = [];
-                    for (var j = 0; j < 9; j++) {
-                        var cellIndex = i * 9 + j;
-                        var cellItem = sudokuCellsRepeater.itemAt(cellIndex);
-                        var cellInput = cellItem.children[0];
-                        row.push(cellInput.text === "" ? 0 : parseInt(cellInput.text));
+                var hint = sudokuGenerator.boardHint(board);
+                if (hint.kind === undefined) {
+                    return;
+                }
+
+                // Highlight the cell to fill or fix, or the cells losing candidates
+                var cells = [];
+                if (hint.kind === "elimination") {
+                    for (var i = 0; i < hint.eliminations.length; i++) {
+                        cells.push(hint.eliminations[i].row * 9 + hint.eliminations[i].col);
                     }
-                    currentGrid.push(row);
+                } else {
+                    cells.push(hint.row * 9 + hint.col);
                 }
-                sudokuGenerator.checkPuzzle(currentGrid);
+                var support = [];
+                for (var j = 0; j < hint.support.length; j++) {
+                    support.push(hint.support[j].row * 9 + hint.support[j].col);
+                }
+                hintCells = cells;
+                hintSupport = support;
+
+                popup.popupTitle = hint.kind === "mistake" ? "Mistake" : hint.technique;
+                popup.popupText = hint.text;
+                popup.showCloseButton = false;
+                popup.showResumeButton = true;
+                popup.visible = true;
             }
         }
     }
@@ -594,6 +634,9 @@ Item {
             
             Text {
                 text: popup.popupText
+                width: parent.width - 40
+                wrapMode: Text.WordWrap
+                horizontalAlignment: Text.AlignHCenter
                 anchors.centerIn: parent
                 color: mainWindow.textMainColour
                 font.pixelSize: 15
@@ -670,12 +713,18 @@ Item {
         }
     }
     
+    // Helper function to remove the highlight of the last hint
+    function clearHint() {
+        hintCells = [];
+        hintSupport = [];
+    }
+
     // Helper function to reset the game
     function resetGame() {
         sudokuGameScreen.selectedNumber = 0;
         mainWindow.gameTimer.running = false;
         mainWindow.gameTimer.seconds = 0;
-        sudokuGenerator.generateSudoku(difficulty);
+        sudokuGenerator.generateBoard(difficulty);
         mainWindow.gameTimer.running = true;
     }
 }
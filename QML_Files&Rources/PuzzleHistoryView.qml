@@ -17,8 +17,8 @@ Item {
     property string date: ""
     property int time: 0
     property int difficulty: 0
-    property string gridString: ""
-    property var grid: []
+    property var board                      // Board value from HistoryModel
+    readonly property int side: board && board.valid ? board.size : 9
     
     // Computed property for difficulty text
     readonly property string difficultyText: {
@@ -30,13 +30,6 @@ Item {
         }
     }
 
-    // Parse the grid data when the component is created
-    Component.onCompleted: {
-        if (gridString) {
-            grid = JSON.parse(gridString);
-        }
-    }
-
     // Screen title
     Rectangle {
         id: historyTitle
@@ -76,39 +69,30 @@ Item {
 
         Grid {
             id: sudokuGrid
-            columns: 9
-            rows: 9
+            columns: puzzleHistoryView.side
+            rows: puzzleHistoryView.side
             spacing: 0
             anchors.fill: parent
 
             // Create cells for each number in the grid
             Repeater {
-                model: 81 // Fixed size for 9x9 grid
+                model: puzzleHistoryView.side * puzzleHistoryView.side
                 
                 Rectangle {
-                    width: sudokuGrid.width / 9
-                    height: sudokuGrid.height / 9
+                    width: sudokuGrid.width / puzzleHistoryView.side
+                    height: sudokuGrid.height / puzzleHistoryView.side
                     color: "transparent"
                     border.width: 1
                     border.color: mainWindow.borderMainColour
                     
-                    // Calculate row and column from index
-                    readonly property int row: Math.floor(index / 9)
-                    readonly property int col: index % 9
-                    readonly property int value: {
-                        if (puzzleHistoryView.grid && 
-                            puzzleHistoryView.grid[row] && 
-                            puzzleHistoryView.grid[row][col] !== undefined) {
-                            return puzzleHistoryView.grid[row][col];
-                        }
-                        return 0;
-                    }
+                    // Cells are read from the board by row-major index
+                    readonly property int value: puzzleHistoryView.board ? puzzleHistoryView.board.cell(index) : 0
 
                     Text {
                         text: value > 0 ? value : ""
                         anchors.centerIn: parent
                         color: mainWindow.textMainColour
-                        font.pixelSize: 20
+                        font.pixelSize: Math.min(20, parent.height * 0.6)
                     }
                 }
             }
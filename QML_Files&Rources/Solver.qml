@@ -9,6 +9,7 @@ import QtQuick 2.15
 import QtQuick.Controls 2.15
 import QtQuick.Layouts 1.15
 import com.sudoku.solver 1.0
+import com.sudoku.board 1.0
 
 Item {
     id: solverScreen
@@ -21,29 +22,12 @@ Item {
     // Currently selected number for input (0 means delete)
     property int selectedNumber: 0
     
-    // Cache for button visibility to avoid repeated calculations
-    property bool gridEmpty: true
-
-    /**
-     * Checks if the grid is completely empty
-     * @return {boolean} True if all cells are empty, false otherwise
-     */
-    function isGridCompletelyEmpty() {
-        for (var i = 0; i < sudokuCellsRepeater.count; ++i) {
-            var cellItem = sudokuCellsRepeater.itemAt(i);
-            var cellInput = cellItem.children[0];
-            if (cellInput.text !== "") {
-                return false;
-            }
-        }
-        return true;
-    }
+    // Whether no cell holds a digit; kept up to date by the board model
+    property bool gridEmpty: board.filledCount === 0
 
     // Initialize the screen
     Component.onCompleted: {
         solverScreen.forceActiveFocus(); // Ensure item can receive key events
-        // Initial check for button visibility
-        gridEmpty = isGridCompletelyEmpty();
         updateButtonVisibility();
     }
 
@@ -52,6 +36,7 @@ Item {
         {
             textIndex=0;
         }
+        updateButtonVisibility();
     }
 
     // Handle keyboard input
@@ -76,24 +61,18 @@ Item {
         resetButton.visible = !gridEmpty;
     }
 
+    // Cells entered by the user; the solver fills in the rest
+    BoardModel {
+        id: board
+    }
+
     // Solver component
     Solver {
         id: sudokuSolver
         
-        // Handle solver results
-        onSudokuSolved: function(success, solution) {
-            if (success) {
-                // Fill the grid with the solution
-                for (var i = 0; i < 9; ++i) {
-                    for (var j = 0; j < 9; ++j) {
-                        var cellIndex = i * 9 + j;
-                        var cellItem = sudokuCellsRepeater.itemAt(cellIndex);
-                        var cellInput = cellItem.children[0];
-                        cellInput.text = solution[i][j].toString();
-                        cellInput.color = "white";
-                    }
-                }
-            } else {
+        // Handle solver results; on success the board has already been filled
+        onBoardSolved: function(success, solution) {
+            if (!success) {
                 // Display a message that the puzzle is unsolvable
                 console.log("Puzzle is unsolvable!");
                 unsolvableText.visible = true;
@@ -161,7 +140,7 @@ Item {
             // Generate 81 cells (9x9)
             Repeater {
                 id: sudokuCellsRepeater
-                model: 81
+                model: board
                 
                 // Individual cell
                 Rectangle {
@@ -171,14 +150,15 @@ Item {
                     border.width: 1
                     border.color: mainWindow.borderMainColour
 
-                    // Cell input field
+                    // Cell input field, showing the model's value
                     TextInput {
                         id: cellInput
                         anchors.fill: parent
                         horizontalAlignment: Text.AlignHCenter
                         verticalAlignment: Text.AlignVCenter
                         font.pixelSize: 20
-                        color: mainWindow.textMainColour
+                        text: model.value === 0 ? "" : model.value.toString()
+                        color: model.correct ? "white" : mainWindow.textMainColour
                         readOnly: true // Make it read-only, input is via selectedNumber
                         validator: IntValidator { bottom: 1; top: 9; }
                     }
@@ -187,20 +167,8 @@ Item {
                     MouseArea {
                         anchors.fill: parent
                         onClicked: {
-                            var wasEmpty = cellInput.text === "";
-                            
-                            if (solverScreen.selectedNumber !== 0) {
-                                cellInput.text = solverScreen.selectedNumber.toString();
-                            } else {
-                                cellInput.text = ""; // Clear the cell if 0 is selected
-                            }
-                            
-                            // Only update button visibility if the empty state changed
-                            var isEmpty = cellInput.text === "";
-                            if (wasEmpty !== isEmpty) {
-                                gridEmpty = isGridCompletelyEmpty();
-                                updateButtonVisibility();
-                            }
+                            // 0 clears the cell; gridEmpty follows the model's filled count
+                            board.setValue(index, solverScreen.selectedNumber);
                             
                             // Hide error message when grid is modified
                             unsolvableText.visible = false;
@@ -239,24 +207,7 @@ Item {
             cursorShape: Qt.BlankCursor
             onPressed: solveButton.color = "#60228201"
             onReleased: solveButton.color = "transparent"
-            onClicked: {
-                // Collect grid data
-                var grid = [];
-                for (var i = 0; i < 9; ++i) {
-                    var row = [];
-                    for (var j = 0; j < 9; ++j) {
-                        var cellIndex = i * 9 + j;
-                        var cellItem = sudokuCellsRepeater.itemAt(cellIndex);
-                        var cellInput = cellItem.children[0];
-                        var value = parseInt(cellInput.text, 10);
-                        row.push(isNaN(value) ? 0 : value);
-                    }
-                    grid.push(row);
-                }
-                
-                // Solve the puzzle
-                sudokuSolver.solvePuzzle(grid);
-            }
+            onClicked: sudokuSolver.solveBoard(board)
         }
     }
 
@@ -311,17 +262,6 @@ Item {
     function resetGrid() {
         unsolvableText.visible = false;
         solverScreen.selectedNumber = 0; // Reset selected number
-        
-        // Clear all cells
-        for (var i = 0; i < sudokuCellsRepeater.count; ++i) {
-            var cellItem = sudokuCellsRepeater.itemAt(i);
-            var cellInput = cellItem.children[0];
-            cellInput.text = "";
-            cellInput.color = "white";
-        }
-        
-        // Update state and button visibility
-        gridEmpty = true;
-        updateButtonVisibility();
+        board.clear(); // gridEmpty and the buttons follow
     }
 }